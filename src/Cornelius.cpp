@@ -20,6 +20,8 @@ void Cornelius::init_cornelius(int dimension, double new_value,
   for (int i = 0; i < DIM; i++) {
     dx[i] = (i < DIM - cube_dimension) ? 1 : new_dx[i - (DIM - cube_dimension)];
   }
+  elements.init_elements(cube_dimension, MAX_ELEMENTS);
+  number_elements = 0;
   initialized = true;
 }
 
@@ -39,11 +41,10 @@ void Cornelius::find_surface_2d(
   cube_2d.init_square(cu, c_i, c_v, dx);
   cube_2d.construct_lines(value);
   number_elements = cube_2d.get_number_lines();
+  elements.clear();
   for (int i = 0; i < number_elements; i++) {
-    for (int j = 0; j < DIM; j++) {
-      normals[i][j] = cube_2d.get_lines()[i].get_normal()[j];
-      centroids[i][j] = cube_2d.get_lines()[i].get_centroid()[j];
-    }
+    elements.add_element(cube_2d.get_lines()[i].get_normal(),
+                         cube_2d.get_lines()[i].get_centroid());
   }
 }
 
@@ -53,6 +54,15 @@ void Cornelius::find_surface_3d(
   surface_3d(cu, position, false);
 }
 
+void Cornelius::find_surface_3d(
+    std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>& cu,
+    const std::array<double, 12>& edge_cuts) {
+  std::array<double, DIM> position = {0};
+  cube_3d.set_edge_cuts(edge_cuts.data());
+  surface_3d(cu, position, false);
+  cube_3d.set_edge_cuts(nullptr);
+}
+
 void Cornelius::find_surface_3d_print(
     std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>& cu,
     std::array<double, DIM>& position) {
@@ -82,6 +92,7 @@ void Cornelius::surface_3d(
   if (value_greater == 0 || value_greater == 8) {
     // No elements in this cube
     number_elements = 0;
+    elements.clear();
     return;
   }
   // This cube has surface elements, start constructing the cube
@@ -92,11 +103,11 @@ void Cornelius::surface_3d(
   cube_3d.construct_polygons(value);
   // Obtain the information about the elements
   number_elements = cube_3d.get_number_polygons();
+  elements.clear();
   for (int i = 0; i < number_elements; i++) {
+    elements.add_element(cube_3d.get_polygons()[i].get_normal(),
+                         cube_3d.get_polygons()[i].get_centroid());
     for (int j = 0; j < DIM; j++) {
-      normals[i][j] = cube_3d.get_polygons()[i].get_normal()[j];
-      centroids[i][j] = cube_3d.get_polygons()[i].get_centroid()[j];
-
       // If the triangles should be printed, print them
       if (print_initialized && do_print) {
         cube_3d.get_polygons()[i].print(output_file, position);
@@ -130,6 +141,7 @@ void Cornelius::find_surface_4d(
   if (value_greater == 0 || value_greater == 16) {
     // No elements in this cube
     number_elements = 0;
+    elements.clear();
     return;
   }
   // This cube has surface elements, start constructing the cube
@@ -138,20 +150,45 @@ void Cornelius::find_surface_4d(
   cube_4d.construct_polyhedra(value);
   // Obtain the information about the elements
   number_elements = cube_4d.get_number_polyhedra();
+  elements.clear();
   for (int i = 0; i < number_elements; i++) {
-    for (int j = 0; j < DIM; j++) {
-      normals[i][j] = cube_4d.get_polyhedra()[i].get_normal()[j];
-      centroids[i][j] = cube_4d.get_polyhedra()[i].get_centroid()[j];
-    }
+    elements.add_element(cube_4d.get_polyhedra()[i].get_normal(),
+                         cube_4d.get_polyhedra()[i].get_centroid());
+  }
+}
+
+void Cornelius::find_surface_4d(
+    std::array<std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>,
+               STEPS>& cu,
+    const std::array<double, 32>& edge_cuts) {
+  cube_4d.set_edge_cuts(edge_cuts.data());
+  find_surface_4d(cu);
+  cube_4d.set_edge_cuts(nullptr);
+}
+
+void Cornelius::find_surface_4d(
+    std::array<std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>,
+               STEPS>& cu,
+    const std::array<double, 32>& edge_cuts,
+    const std::array<const std::array<double, DIM>*, DIM>&
+        lower_face_centroids) {
+  for (int i = 0; i < DIM; i++) {
+    cube_4d.set_lower_face_centroid(i, lower_face_centroids[i]);
+  }
+  find_surface_4d(cu, edge_cuts);
+  for (int i = 0; i < DIM; i++) {
+    cube_4d.set_lower_face_centroid(i, nullptr);
   }
 }
 
 std::vector<std::vector<double>> Cornelius::get_normals() {
   std::vector<std::vector<double>> normals_vector(
       number_elements, std::vector<double>(cube_dimension));
-  for (int i = 0; i < number_elements; i++) {
-    std::copy(normals[i].begin() + (DIM - cube_dimension),
-              normals[i].begin() + DIM, normals_vector[i].begin());
+  for (int j = 0; j < cube_dimension; j++) {
+    SurfaceElements::Span component = elements.get_normal_component(j);
+    for (int i = 0; i < number_elements; i++) {
+      normals_vector[i][j] = component[i];
+    }
   }
   return normals_vector;
 }
@@ -159,9 +196,11 @@ std::vector<std::vector<double>> Cornelius::get_normals() {
 std::vector<std::vector<double>> Cornelius::get_centroids() {
   std::vector<std::vector<double>> centroids_vector(
       number_elements, std::vector<double>(cube_dimension));
-  for (int i = 0; i < number_elements; i++) {
-    std::copy(centroids[i].begin() + (DIM - cube_dimension),
-              centroids[i].begin() + DIM, centroids_vector[i].begin());
+  for (int j = 0; j < cube_dimension; j++) {
+    SurfaceElements::Span component = elements.get_centroid_component(j);
+    for (int i = 0; i < number_elements; i++) {
+      centroids_vector[i][j] = component[i];
+    }
   }
   return centroids_vector;
 }
@@ -173,8 +212,8 @@ double Cornelius::get_centroid_element(int index_surface_element,
     throw std::out_of_range(
         "Cornelius error: asking for an element which does not exist.");
   }
-  return centroids[index_surface_element]
-                  [element_centroid + (DIM - cube_dimension)];
+  return elements.get_centroid_element(index_surface_element,
+                                       element_centroid);
 }
 
 double Cornelius::get_normal_element(int index_surface_element,
@@ -184,6 +223,5 @@ double Cornelius::get_normal_element(int index_surface_element,
     throw std::out_of_range(
         "Cornelius error: asking for an element which does not exist.");
   }
-  return normals[index_surface_element]
-                [element_normal + (DIM - cube_dimension)];
-}
\ No newline at end of file
+  return elements.get_normal_element(index_surface_element, element_normal);
+}
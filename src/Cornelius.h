@@ -44,6 +44,7 @@
 #include "GeneralGeometryElement.h"
 #include "Hypercube.h"
 #include "Square.h"
+#include "SurfaceElements.h"
 
 /**
  *
@@ -65,10 +66,7 @@ class Cornelius : public GeneralGeometryElement {
   static constexpr int MAX_ELEMENTS = 10; /**< Maximum number of elements */
 
   int number_elements; /**< Number of surface elements found */
-  std::array<std::array<double, DIM>, MAX_ELEMENTS>
-      normals; /**< Array to store the normals of the surface elements */
-  std::array<std::array<double, DIM>, MAX_ELEMENTS>
-      centroids; /**< Array to store the centroids of the surface elements */
+  SurfaceElements elements; /**< Normals and centroids of the elements */
   int cube_dimension; /**< Dimension of the cube (2, 3, or 4) */
   bool initialized;   /**< Flag to indicate if Cornelius has been initialized */
   bool print_initialized; /**< Flag to indicate if printing is initialized */
@@ -142,6 +140,25 @@ class Cornelius : public GeneralGeometryElement {
   void find_surface_3d(
       std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>& cu);
 
+  /**
+   * @brief Finds surface elements in a 3D cube with the cut points on the
+   * edges computed by the caller.
+   *
+   * In a lattice every edge belongs to several cells, so the cuts can be
+   * computed once for all of them. The results are the same as without the
+   * cuts.
+   *
+   * @param cu Values at the corners of the cube as a 3d table so that value
+   *                  [0][0][0] is at (0,0,0) and [1][1][1] is at (dx1,dx2,dx3).
+   * @param edge_cuts Position of the cut on each edge relative to its lower
+   * corner as given by Square::edge_cut(). The edge along direction d
+   * starting from the corner [c0][c1][c2] has the index 4 * d plus the two
+   * other corner indices read as a binary number.
+   */
+  void find_surface_3d(
+      std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>& cu,
+      const std::array<double, 12>& edge_cuts);
+
   /**
    * @brief Finds the surface elements in 3-dimensional case and prints the
    * actual triangles which are found by the algorithm.
@@ -167,6 +184,67 @@ class Cornelius : public GeneralGeometryElement {
           std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>,
           STEPS>& cu);
 
+  /**
+   * @brief Finds surface elements in a 4D hypercube with the cut points on
+   * the edges computed by the caller.
+   *
+   * In a lattice every edge belongs to several cells, so the cuts can be
+   * computed once for all of them. The results are the same as without the
+   * cuts.
+   *
+   * @param cu Values at the corners of the cube as a 4d table so that value
+   *                  [0][0][0][0] is at (0,0,0,0) and [1][1][1][1] is at
+   *                  (dx1,dx2,dx3,dx4).
+   * @param edge_cuts Position of the cut on each edge relative to its lower
+   * corner as given by Square::edge_cut(). The edge along direction d
+   * starting from the corner [c0][c1][c2][c3] has the index 8 * d plus the
+   * three other corner indices read as a binary number.
+   */
+  void find_surface_4d(
+      std::array<
+          std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>,
+          STEPS>& cu,
+      const std::array<double, 32>& edge_cuts);
+
+  /**
+   * @brief Finds surface elements in a 4D hypercube with the cut points on
+   * the edges and the centroids of the polygons on some of the lower faces
+   * given by the caller.
+   *
+   * The upper face of a hypercube is the lower face of its neighbour, so
+   * the centroid found for it with get_upper_face_centroid() can be handed
+   * to the neighbour. The results are the same as without the centroids.
+   *
+   * @param cu Values at the corners of the cube as a 4d table.
+   * @param edge_cuts Position of the cut on each edge as in the overload
+   * above.
+   * @param lower_face_centroids Centroid of the polygon on the lower face in
+   * each direction, or a null pointer. It must belong to a hypercube with
+   * the same dx whose upper face has the same values as the lower face of
+   * this one.
+   */
+  void find_surface_4d(
+      std::array<
+          std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>,
+          STEPS>& cu,
+      const std::array<double, 32>& edge_cuts,
+      const std::array<const std::array<double, DIM>*, DIM>&
+          lower_face_centroids);
+
+  /**
+   * @brief Gets the centroid of the polygon on the upper face in one
+   * direction of the last 4D hypercube with surface elements.
+   *
+   * @param direction Direction normal to the face.
+   * @return Pointer to the centroid, valid until the next search, or a null
+   * pointer if it is not available.
+   */
+  inline const std::array<double, DIM>* get_upper_face_centroid(
+      int direction) {
+    return (number_elements > 0) ? cube_4d.get_upper_face_centroid(direction)
+                                 : nullptr;
+  }
+
   /**
    * @brief Gets the number of surface elements found.
    *
@@ -174,10 +252,44 @@ class Cornelius : public GeneralGeometryElement {
    */
   inline int get_number_elements() { return number_elements; }
 
+  /**
+   * @brief Gets the surface elements found in the last cube.
+   *
+   * The container is reused for every cube, so reading it out does not
+   * allocate. It is valid until the next cube is searched.
+   *
+   * @return The normals and centroids of the elements.
+   */
+  inline const SurfaceElements& get_elements() { return elements; }
+
+  /**
+   * @brief Gets one component of the normals of all elements without copying.
+   *
+   * @param component The index of the component. Valid values are
+   *               [0,dimension of the problem].
+   * @return A view of the component with get_number_elements() values.
+   */
+  inline SurfaceElements::Span get_normal_component(int component) {
+    return elements.get_normal_component(component);
+  }
+
+  /**
+   * @brief Gets one component of the centroids of all elements without
+   * copying.
+   *
+   * @param component The index of the component. Valid values are
+   *               [0,dimension of the problem].
+   * @return A view of the component with get_number_elements() values.
+   */
+  inline SurfaceElements::Span get_centroid_component(int component) {
+    return elements.get_centroid_component(component);
+  }
+
   /**
    * @brief Normal vectors as a 2d table with the following number of indices
    * [number of elements][dimension of the problem]. This gives \sigma_\mu
-   * without factors(sqrt(-g)) from the metric.
+   * without factors(sqrt(-g)) from the metric. A new table is allocated for
+   * every call, get_elements() and get_normal_component() avoid this.
    *
    * @return A vector of vectors with dimensions [number of
    * elements][dimension of the problem] containing the normal vectors of the
@@ -187,7 +299,8 @@ class Cornelius : public GeneralGeometryElement {
 
   /**
    * @brief Centroid vectors as a 2d table with the following number of indices
-   * [number of elements][dimension of the problem].
+   * [number of elements][dimension of the problem]. A new table is allocated
+   * for every call, get_elements() and get_centroid_component() avoid this.
    *
    * @return A vector of vectors representing the centroids.
    */
@@ -0,0 +1,771 @@
+#include "CorneliusGrid.h"
+
+CorneliusGrid::CorneliusGrid()
+    : grid_dimension(0),
+      initialized(false),
+      number_threads(1),
+      reuse_time_faces(false),
+      next_tile(0),
+      next_range(0),
+      pool_work(nullptr),
+      pool_threads_used(0),
+      pool_running(0),
+      pool_round(0),
+      pool_stop(false) {
+  engines.push_back(std::make_unique<Cornelius>());
+  thread_elements.resize(1);
+  thread_cuts.resize(1);
+  thread_pending.resize(1);
+  thread_patterns.resize(1);
+  thread_faces.resize(1);
+  thread_space_faces.resize(1);
+  loads.resize(1, {0, 0, 0, 0.0});
+}
+
+CorneliusGrid::~CorneliusGrid() { stop_workers(); }
+
+void CorneliusGrid::init_grid(int dimension, double new_value,
+                              std::array<int, DIM>& new_number_points,
+                              std::array<double, DIM>& new_dx) {
+  if (dimension != 3 && dimension != 4) {
+    std::cerr << "CorneliusGrid supports only 3D and 4D lattices." << std::endl;
+    exit(1);
+  }
+  for (int i = 0; i < dimension; i++) {
+    if (new_number_points[i] < 2) {
+      std::cerr << "CorneliusGrid needs at least two points in each "
+                   "direction."
+                << std::endl;
+      exit(1);
+    }
+  }
+  grid_dimension = dimension;
+  value = new_value;
+  dx = new_dx;
+  number_points = new_number_points;
+  elements.init_elements(dimension);
+  // Faces of a previous lattice must not be reused
+  face_refs.clear();
+  initialized = true;
+}
+
+void CorneliusGrid::set_number_threads(int new_number_threads) {
+  if (new_number_threads < 1) {
+    new_number_threads =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  if (new_number_threads != number_threads) {
+    stop_workers();
+  }
+  number_threads = new_number_threads;
+  for (int t = static_cast<int>(workers.size()) + 1; t < number_threads; t++) {
+    workers.emplace_back(&CorneliusGrid::worker_loop, this, t, pool_round);
+  }
+  while (static_cast<int>(engines.size()) < number_threads) {
+    engines.push_back(std::make_unique<Cornelius>());
+  }
+  thread_elements.resize(number_threads);
+  thread_cuts.resize(number_threads);
+  thread_pending.resize(number_threads);
+  thread_patterns.resize(number_threads);
+  thread_faces.resize(number_threads);
+  thread_space_faces.resize(number_threads);
+  loads.resize(number_threads, {0, 0, 0, 0.0});
+}
+
+const CorneliusGrid::ThreadLoad& CorneliusGrid::get_thread_load(
+    int thread_index) {
+  if (thread_index < 0 || thread_index >= number_threads) {
+    throw std::out_of_range(
+        "CorneliusGrid error: asking for a thread which does not exist.");
+  }
+  return loads[thread_index];
+}
+
+void CorneliusGrid::find_surface(const double* field) {
+  if (!initialized) {
+    std::cerr << "CorneliusGrid not initialized." << std::endl;
+    exit(1);
+  }
+  clear_elements();
+  std::size_t slice_size = 1;
+  for (int i = 1; i < grid_dimension; i++) {
+    slice_size *= number_points[i];
+  }
+  // All slabs are searched at once, so that the threads are started only
+  // once for the whole lattice
+  slabs.clear();
+  range_slices.clear();
+  for (int i = 0; i < number_points[0]; i++) {
+    range_slices.push_back(field + i * slice_size);
+  }
+  build_slice_ranges();
+  for (int i = 0; i < number_points[0] - 1; i++) {
+    slabs.push_back({field + i * slice_size, field + (i + 1) * slice_size, i,
+                     i * dx[0], dx[0], &slice_ranges[i],
+                     &slice_ranges[i + 1]});
+  }
+  // The slabs are searched in parallel, so no slab can wait for the faces of
+  // the previous one
+  reuse_time_faces = false;
+  scan_slabs();
+}
+
+void CorneliusGrid::append_slab(const double* slice0, const double* slice1,
+                                int time_index, double tau0, double dt) {
+  if (!initialized) {
+    std::cerr << "CorneliusGrid not initialized." << std::endl;
+    exit(1);
+  }
+  range_slices = {slice0, slice1};
+  build_slice_ranges();
+  append_slab(slice0, slice1, time_index, tau0, dt, slice_ranges[0],
+              slice_ranges[1]);
+}
+
+void CorneliusGrid::append_slab(const double* slice0, const double* slice1,
+                                int time_index, double tau0, double dt,
+                                const SliceRange& range0,
+                                const SliceRange& range1) {
+  if (!initialized) {
+    std::cerr << "CorneliusGrid not initialized." << std::endl;
+    exit(1);
+  }
+  // The lines of a plane run along the last direction
+  const int lines_per_plane = (grid_dimension == 4) ? number_points[2] : 1;
+  const std::size_t line_size = number_points[grid_dimension - 1];
+  for (const SliceRange* range : {&range0, &range1}) {
+    if (range->get_number_planes() != number_points[1] ||
+        range->get_lines_per_plane() != lines_per_plane ||
+        range->get_line_size() != line_size || range->get_value() != value) {
+      std::cerr << "CorneliusGrid error: the value ranges do not match the "
+                   "lattice."
+                << std::endl;
+      exit(1);
+    }
+  }
+  slabs.clear();
+  slabs.push_back({slice0, slice1, time_index, tau0, dt, &range0, &range1});
+  reuse_time_faces = (grid_dimension == 4);
+  if (reuse_time_faces) {
+    const std::size_t number_cells =
+        static_cast<std::size_t>(number_points[1] - 1) *
+        (number_points[2] - 1) * (number_points[3] - 1);
+    if (face_refs.size() != number_cells) {
+      face_refs.assign(number_cells, {std::numeric_limits<int>::min(), 0, 0});
+    }
+    for (TimeFaces& faces : thread_faces) {
+      faces.number_faces[time_index & 1] = 0;
+    }
+  }
+  scan_slabs();
+}
+
+void CorneliusGrid::scan_slabs() {
+  const std::size_t rows_per_slab = number_points[1] - 1;
+  const std::size_t number_tiles = slabs.size() * rows_per_slab;
+  for (auto& load : loads) {
+    load = {0, 0, 0, 0.0};
+  }
+  if (number_tiles == 0) {
+    return;
+  }
+  tiles.resize(number_tiles);
+  next_tile = 0;
+  const int threads_used = static_cast<int>(
+      std::min<std::size_t>(number_threads, number_tiles));
+  run_threads(threads_used, &CorneliusGrid::scan_tiles);
+  // Exclusive prefix sum over the tiles. The tiles are in lattice order, so
+  // the elements are in lattice order no matter which thread has searched
+  // which tile.
+  std::size_t offset = elements.size();
+  for (TileRange& tile : tiles) {
+    tile.offset = offset;
+    offset += tile.end - tile.begin;
+  }
+  elements.resize(offset);
+  run_threads(threads_used, &CorneliusGrid::copy_tiles);
+}
+
+void CorneliusGrid::build_slice_ranges() {
+  const std::size_t number_slices = range_slices.size();
+  if (slice_ranges.size() < number_slices) {
+    slice_ranges.resize(number_slices);
+  }
+  // The lines of a plane run along the last direction
+  for (std::size_t s = 0; s < number_slices; s++) {
+    if (grid_dimension == 4) {
+      slice_ranges[s].init_slice_range(number_points[1], number_points[2],
+                                       number_points[3]);
+    } else {
+      slice_ranges[s].init_slice_range(number_points[1], 1, number_points[2]);
+    }
+  }
+  next_range = 0;
+  const int threads_used =
+      static_cast<int>(std::min<std::size_t>(number_threads, number_slices));
+  run_threads(threads_used, &CorneliusGrid::scan_ranges);
+}
+
+void CorneliusGrid::scan_ranges(int /* thread_index */) {
+  for (std::size_t s = next_range++; s < range_slices.size();
+       s = next_range++) {
+    slice_ranges[s].build(range_slices[s], value);
+  }
+}
+
+void CorneliusGrid::run_threads(int threads_used,
+                                void (CorneliusGrid::*work)(int)) {
+  if (threads_used > 1) {
+    {
+      std::lock_guard<std::mutex> lock(pool_mutex);
+      pool_work = work;
+      pool_threads_used = threads_used;
+      pool_running = threads_used - 1;
+      pool_round++;
+    }
+    pool_start.notify_all();
+  }
+  (this->*work)(0);
+  if (threads_used > 1) {
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    pool_done.wait(lock, [this] { return pool_running == 0; });
+  }
+}
+
+void CorneliusGrid::worker_loop(int thread_index, long round) {
+  std::unique_lock<std::mutex> lock(pool_mutex);
+  while (true) {
+    pool_start.wait(lock,
+                    [this, round] { return pool_stop || pool_round != round; });
+    if (pool_stop) {
+      return;
+    }
+    round = pool_round;
+    // Workers beyond the threads used sit this round out
+    if (thread_index >= pool_threads_used) {
+      continue;
+    }
+    void (CorneliusGrid::*work)(int) = pool_work;
+    lock.unlock();
+    (this->*work)(thread_index);
+    lock.lock();
+    if (--pool_running == 0) {
+      pool_done.notify_one();
+    }
+  }
+}
+
+void CorneliusGrid::stop_workers() {
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    pool_stop = true;
+  }
+  pool_start.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+  pool_stop = false;
+}
+
+void CorneliusGrid::scan_tiles(int thread_index) {
+  const auto start = std::chrono::steady_clock::now();
+  Cornelius& engine = *engines[thread_index];
+  Elements& found = thread_elements[thread_index];
+  ThreadLoad& load = loads[thread_index];
+  EdgeCuts& cuts = thread_cuts[thread_index];
+  PendingCells& pending = thread_pending[thread_index];
+  std::vector<int>& patterns = thread_patterns[thread_index];
+  found.init_elements(grid_dimension);
+  // The slab list may have changed since the last search
+  cuts.slab = nullptr;
+  thread_space_faces[thread_index].slab = nullptr;
+  const std::size_t rows_per_slab = number_points[1] - 1;
+  long cells_per_tile = 1;
+  for (int i = 2; i < grid_dimension; i++) {
+    cells_per_tile *= number_points[i] - 1;
+  }
+  const Slab* last_slab = nullptr;
+  for (std::size_t tile = next_tile++; tile < tiles.size();
+       tile = next_tile++) {
+    const Slab& slab = slabs[tile / rows_per_slab];
+    if (&slab != last_slab) {
+      // The time step may change from one slab to the next
+      std::array<double, DIM> slab_dx = dx;
+      slab_dx[0] = slab.dt;
+      engine.init_cornelius(grid_dimension, value, slab_dx);
+      if (grid_dimension == 3) {
+        // The cells of the previous slab have a different size
+        flush_cells(pending, found);
+        pending.batch.init_batch({slab.dt, dx[1], dx[2], 0.0});
+        pending.tau0 = slab.tau0;
+      }
+      last_slab = &slab;
+    }
+    const std::size_t begin = found.size();
+    const int j = static_cast<int>(tile % rows_per_slab);
+    // Only rows crossed by the surface are searched. The edge cuts and the
+    // faces of the next row are then found from scratch, since they are
+    // reused only from the row just before.
+    if (classify_row(slab, j, patterns) > 0) {
+      cut_row(cuts, slab, j);
+      if (grid_dimension == 3) {
+        row_3d(engine, slab, j, cuts, patterns, pending, found);
+      } else {
+        row_4d(engine, slab, j, cuts, patterns, thread_index, found);
+      }
+    }
+    tiles[tile] = {thread_index, begin, found.size(), 0};
+    load.tiles++;
+    load.cells += cells_per_tile;
+  }
+  if (grid_dimension == 3) {
+    flush_cells(pending, found);
+  }
+  load.elements = static_cast<long>(found.size());
+  load.seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+}
+
+void CorneliusGrid::copy_tiles(int thread_index) {
+  const Elements& found = thread_elements[thread_index];
+  for (const TileRange& tile : tiles) {
+    if (tile.thread_index != thread_index) {
+      continue;
+    }
+    for (int i = 0; i < grid_dimension; i++) {
+      std::copy(found.cells[i].begin() + tile.begin,
+                found.cells[i].begin() + tile.end,
+                elements.cells[i].begin() + tile.offset);
+      std::copy(found.normals[i].begin() + tile.begin,
+                found.normals[i].begin() + tile.end,
+                elements.normals[i].begin() + tile.offset);
+      std::copy(found.centroids[i].begin() + tile.begin,
+                found.centroids[i].begin() + tile.end,
+                elements.centroids[i].begin() + tile.offset);
+    }
+  }
+}
+
+void CorneliusGrid::collect_elements(Cornelius& engine,
+                                     const std::array<int, DIM>& cell,
+                                     double tau0, Elements& found) {
+  const SurfaceElements& cell_elements = engine.get_elements();
+  const int number_elements = cell_elements.get_number_elements();
+  for (int j = 0; j < grid_dimension; j++) {
+    SurfaceElements::Span normal = cell_elements.get_normal_component(j);
+    SurfaceElements::Span centroid = cell_elements.get_centroid_component(j);
+    // Shift the centroid from the cell to the lattice origin
+    const double shift = (j == 0) ? tau0 : cell[j] * dx[j];
+    found.cells[j].insert(found.cells[j].end(), number_elements, cell[j]);
+    found.normals[j].insert(found.normals[j].end(), normal.begin(),
+                            normal.end());
+    for (double x : centroid) {
+      found.centroids[j].push_back(x + shift);
+    }
+  }
+}
+
+void CorneliusGrid::flush_cells(PendingCells& pending, Elements& found) {
+  pending.batch.find_elements();
+  for (int cell = 0; cell < pending.batch.get_number_cells(); cell++) {
+    const std::size_t slot = pending.slots[cell];
+    for (int j = 0; j < 3; j++) {
+      // Shift the centroid from the cell to the lattice origin
+      const double shift =
+          (j == 0) ? pending.tau0 : found.cells[j][slot] * dx[j];
+      found.normals[j][slot] = pending.batch.get_normal_element(cell, j);
+      found.centroids[j][slot] =
+          pending.batch.get_centroid_element(cell, j) + shift;
+    }
+  }
+  pending.batch.clear();
+  pending.slots.clear();
+}
+
+void CorneliusGrid::cut_plane(EdgeCuts& cuts, const Slab& slab, int j,
+                              int plane) {
+  const std::size_t n2 = number_points[2];
+  const std::size_t n3 = (grid_dimension == 4) ? number_points[3] : 1;
+  const std::size_t plane_size = n2 * n3;
+  std::array<const double*, STEPS> slices = {slab.slice0 + j * plane_size,
+                                             slab.slice1 + j * plane_size};
+  cuts.time[plane].resize(plane_size);
+  for (std::size_t p = 0; p < plane_size; p++) {
+    cuts.time[plane][p] =
+        Square::edge_cut(slices[0][p], slices[1][p], value, slab.dt);
+  }
+  for (int s = 0; s < STEPS; s++) {
+    const double* slice = slices[s];
+    std::vector<double>& y = cuts.y[plane][s];
+    y.resize(plane_size);
+    for (std::size_t p = 0; p + n3 < plane_size; p++) {
+      y[p] = Square::edge_cut(slice[p], slice[p + n3], value, dx[2]);
+    }
+    if (grid_dimension == 4) {
+      std::vector<double>& z = cuts.z[plane][s];
+      z.resize(plane_size);
+      for (std::size_t p = 0; p + 1 < plane_size; p++) {
+        z[p] = Square::edge_cut(slice[p], slice[p + 1], value, dx[3]);
+      }
+    }
+  }
+}
+
+void CorneliusGrid::cut_row(EdgeCuts& cuts, const Slab& slab, int j) {
+  if (cuts.slab == &slab && cuts.row == j - 1) {
+    // The upper plane of the previous row is the lower plane of this row
+    cuts.lower ^= 1;
+  } else {
+    cuts.lower = 0;
+    cut_plane(cuts, slab, j, cuts.lower);
+  }
+  cut_plane(cuts, slab, j + 1, cuts.lower ^ 1);
+  cuts.slab = &slab;
+  cuts.row = j;
+
+  const std::size_t n2 = number_points[2];
+  const std::size_t n3 = (grid_dimension == 4) ? number_points[3] : 1;
+  const std::size_t plane_size = n2 * n3;
+  std::array<const double*, STEPS> slices = {slab.slice0 + j * plane_size,
+                                             slab.slice1 + j * plane_size};
+  for (int s = 0; s < STEPS; s++) {
+    const double* slice = slices[s];
+    std::vector<double>& x = cuts.x[s];
+    x.resize(plane_size);
+    for (std::size_t p = 0; p < plane_size; p++) {
+      x[p] = Square::edge_cut(slice[p], slice[p + plane_size], value, dx[1]);
+    }
+  }
+}
+
+int CorneliusGrid::classify_row(const Slab& slab, int j,
+                                std::vector<int>& patterns) {
+  const std::size_t n2 = number_points[2];
+  const std::size_t n3 = (grid_dimension == 4) ? number_points[3] : 1;
+  const int number_corners = 1 << grid_dimension;
+  // In 4D the cells of a line with fixed k are consecutive
+  const std::size_t lines = (grid_dimension == 4) ? n2 - 1 : 1;
+  const std::size_t cells_per_line = (grid_dimension == 4) ? n3 - 1 : n2 - 1;
+  patterns.assign(lines * cells_per_line, 0);
+
+  // The whole row is skipped if no plane may be crossed
+  SliceRange::Range row_range = SliceRange::empty_range();
+  for (const SliceRange* slice_range : {slab.range0, slab.range1}) {
+    for (int plane = j; plane < j + STEPS; plane++) {
+      SliceRange::merge(row_range, slice_range->get_plane_range(plane));
+    }
+  }
+  if (!SliceRange::may_cross(row_range, value)) {
+    return 0;
+  }
+
+  std::array<const SliceRange*, STEPS> slices = {slab.range0, slab.range1};
+  // The corner c of a cell lies on the line c / 2 of the points below, in
+  // the cell itself for even and in the next cell for odd c
+  const int number_lines = number_corners / 2;
+  std::array<const std::uint64_t*, 8> signs;
+  const std::size_t number_words =
+      (cells_per_line + SliceRange::WORD - 1) / SliceRange::WORD;
+  int crossed = 0;
+  for (std::size_t line = 0; line < lines; line++) {
+    SliceRange::Range line_range = SliceRange::empty_range();
+    for (int s = 0; s < number_lines; s++) {
+      const int ci = s >> (grid_dimension - 2);
+      const int cj = (s >> (grid_dimension - 3)) & 1;
+      const int ck = (grid_dimension == 4) ? (s & 1) : 0;
+      const int point_line = static_cast<int>(line) + ck;
+      signs[s] = slices[ci]->get_signs(j + cj, point_line);
+      SliceRange::merge(line_range,
+                        slices[ci]->get_line_range(j + cj, point_line));
+    }
+    // Lines of cells whose corners cannot be crossed are skipped
+    if (!SliceRange::may_cross(line_range, value)) {
+      continue;
+    }
+    int* line_patterns = patterns.data() + line * cells_per_line;
+    for (std::size_t w = 0; w < number_words; w++) {
+      // Bit b is set if all or any of the corners of the cell 64 * w + b
+      // are at or above the value
+      std::uint64_t all_above = ~std::uint64_t(0);
+      std::uint64_t any_above = 0;
+      for (int s = 0; s < number_lines; s++) {
+        const std::uint64_t lower = signs[s][w];
+        const std::uint64_t upper = (lower >> 1) | (signs[s][w + 1] << 63);
+        all_above &= lower & upper;
+        any_above |= lower | upper;
+      }
+      std::uint64_t cut = any_above & ~all_above;
+      // The last point of the line does not start a cell
+      if ((w + 1) * SliceRange::WORD > cells_per_line) {
+        cut &= (std::uint64_t(1) << (cells_per_line % SliceRange::WORD)) - 1;
+      }
+      crossed += __builtin_popcountll(cut);
+      while (cut != 0) {
+        const int b = __builtin_ctzll(cut);
+        cut &= cut - 1;
+        const std::size_t p = w * SliceRange::WORD + b;
+        int pattern = 0;
+        for (int c = 0; c < number_corners; c++) {
+          const std::size_t point = p + (c & 1);
+          const std::uint64_t word = signs[c >> 1][point / SliceRange::WORD];
+          pattern |= static_cast<int>((word >> (point % SliceRange::WORD)) & 1)
+                     << c;
+        }
+        line_patterns[p] = pattern;
+      }
+    }
+  }
+  return crossed;
+}
+
+void CorneliusGrid::row_3d(Cornelius& engine, const Slab& slab, int j,
+                           const EdgeCuts& cuts,
+                           const std::vector<int>& patterns,
+                           PendingCells& pending, Elements& found) {
+  const std::size_t n2 = number_points[2];
+  std::array<const double*, STEPS> slices = {slab.slice0, slab.slice1};
+  std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS> cu;
+  std::array<double, 12> cell_cuts;
+  const std::array<int, STEPS> planes = {cuts.lower, cuts.lower ^ 1};
+  for (int k = 0; k < number_points[2] - 1; k++) {
+    const int pattern = patterns[k];
+    if (pattern == 0) {
+      continue;
+    }
+    // Copy the corners of the cell
+    for (int ci = 0; ci < STEPS; ci++) {
+      for (int cj = 0; cj < STEPS; cj++) {
+        const std::size_t row = (j + cj) * n2 + k;
+        cu[ci][cj][0] = slices[ci][row];
+        cu[ci][cj][1] = slices[ci][row + 1];
+      }
+    }
+    // Gather the cuts of the 12 edges, numbered as in Cube
+    for (int a = 0; a < STEPS; a++) {
+      for (int b = 0; b < STEPS; b++) {
+        cell_cuts[2 * a + b] = cuts.time[planes[a]][k + b];
+        cell_cuts[4 + 2 * a + b] = cuts.x[a][k + b];
+        cell_cuts[8 + 2 * a + b] = cuts.y[planes[b]][a][k];
+      }
+    }
+    if (pending.batch.add_cell(pattern, cell_cuts) >= 0) {
+      // Reserve the element, it is filled in when the batch is done
+      const std::size_t slot = found.size();
+      found.resize(slot + 1);
+      found.cells[0][slot] = slab.time_index;
+      found.cells[1][slot] = j;
+      found.cells[2][slot] = k;
+      pending.slots.push_back(slot);
+      continue;
+    }
+    engine.find_surface_3d(cu, cell_cuts);
+    if (engine.get_number_elements() > 0) {
+      collect_elements(engine, {slab.time_index, j, k, 0}, slab.tau0, found);
+    }
+  }
+}
+
+void CorneliusGrid::row_4d(Cornelius& engine, const Slab& slab, int j,
+                           const EdgeCuts& cuts,
+                           const std::vector<int>& patterns, int thread_index,
+                           Elements& found) {
+  const std::size_t n2 = number_points[2];
+  const std::size_t n3 = number_points[3];
+  std::array<const double*, STEPS> slices = {slab.slice0, slab.slice1};
+  std::array<std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>,
+             STEPS>
+      cu;
+  std::array<double, 32> cell_cuts;
+  const std::array<int, STEPS> planes = {cuts.lower, cuts.lower ^ 1};
+  SpaceFaces& space_faces = thread_space_faces[thread_index];
+  roll_space_faces(space_faces, slab, j);
+  std::vector<Face>& x_previous = space_faces.x[space_faces.lower];
+  std::vector<Face>& x_current = space_faces.x[space_faces.lower ^ 1];
+  std::array<const std::array<double, DIM>*, DIM> lower_faces;
+  std::array<double, 8> corners;
+  for (int k = 0; k < number_points[2] - 1; k++) {
+    std::vector<Face>& y_previous = space_faces.y[(k & 1) ^ 1];
+    std::vector<Face>& y_current = space_faces.y[k & 1];
+    space_faces.z[1].valid = false;
+    for (int l = 0; l < number_points[3] - 1; l++) {
+      const std::size_t p = k * n3 + l;
+      const std::size_t space_cell = k * (n3 - 1) + l;
+      Face& z_previous = space_faces.z[(l & 1) ^ 1];
+      Face& z_current = space_faces.z[l & 1];
+      const int pattern = patterns[space_cell];
+      if (pattern == 0) {
+        x_current[space_cell].valid = false;
+        y_current[l].valid = false;
+        z_current.valid = false;
+        continue;
+      }
+      // Copy the corners of the cell
+      for (int ci = 0; ci < STEPS; ci++) {
+        for (int cj = 0; cj < STEPS; cj++) {
+          for (int ck = 0; ck < STEPS; ck++) {
+            const std::size_t row = ((j + cj) * n2 + (k + ck)) * n3 + l;
+            cu[ci][cj][ck][0] = slices[ci][row];
+            cu[ci][cj][ck][1] = slices[ci][row + 1];
+          }
+        }
+      }
+      // Gather the cuts of the 32 edges, numbered as in Hypercube
+      for (int a = 0; a < STEPS; a++) {
+        for (int b = 0; b < STEPS; b++) {
+          for (int c = 0; c < STEPS; c++) {
+            const int bits = 4 * a + 2 * b + c;
+            cell_cuts[bits] = cuts.time[planes[a]][p + b * n3 + c];
+            cell_cuts[8 + bits] = cuts.x[a][p + b * n3 + c];
+            cell_cuts[16 + bits] = cuts.y[planes[b]][a][p + c];
+            cell_cuts[24 + bits] = cuts.z[planes[b]][a][p + c * n3];
+          }
+        }
+      }
+      // Centroids on the lower faces which were upper faces of the previous
+      // cells
+      std::array<const Face*, DIM> previous = {
+          nullptr, &x_previous[space_cell], &y_previous[l], &z_previous};
+      FaceRef* face_ref = nullptr;
+      lower_faces[0] = nullptr;
+      if (reuse_time_faces) {
+        face_ref = &face_refs[(j * (n2 - 1) + k) * (n3 - 1) + l];
+        face_corners(cu, 0, 0, corners);
+        lower_faces[0] = find_time_face(*face_ref, slab.time_index - 1,
+                                        corners);
+      }
+      for (int d = 1; d < DIM; d++) {
+        lower_faces[d] = previous[d]->valid ? &previous[d]->centroid : nullptr;
+      }
+      engine.find_surface_4d(cu, cell_cuts, lower_faces);
+      const std::array<double, DIM>* upper_time_face =
+          engine.get_upper_face_centroid(0);
+      if (face_ref != nullptr && upper_time_face != nullptr) {
+        face_corners(cu, 0, 1, corners);
+        store_time_face(*face_ref, slab.time_index, thread_index, corners,
+                        *upper_time_face);
+      }
+      std::array<Face*, DIM> current = {nullptr, &x_current[space_cell],
+                                        &y_current[l], &z_current};
+      for (int d = 1; d < DIM; d++) {
+        const std::array<double, DIM>* upper_face =
+            engine.get_upper_face_centroid(d);
+        current[d]->valid = (upper_face != nullptr);
+        if (upper_face != nullptr) {
+          current[d]->centroid = *upper_face;
+        }
+      }
+      if (engine.get_number_elements() > 0) {
+        collect_elements(engine, {slab.time_index, j, k, l}, slab.tau0,
+                         found);
+      }
+    }
+  }
+}
+
+void CorneliusGrid::roll_space_faces(SpaceFaces& faces, const Slab& slab,
+                                     int j) {
+  const std::size_t row_size = static_cast<std::size_t>(number_points[2] - 1) *
+                               (number_points[3] - 1);
+  if (faces.slab == &slab && faces.row == j - 1) {
+    // The current row of the last call is the previous row of this one
+    faces.lower ^= 1;
+  } else {
+    faces.lower = 0;
+    faces.x[0].resize(row_size);
+    for (Face& face : faces.x[0]) {
+      face.valid = false;
+    }
+  }
+  faces.x[faces.lower ^ 1].resize(row_size);
+  faces.slab = &slab;
+  faces.row = j;
+  for (int s = 0; s < STEPS; s++) {
+    faces.y[s].resize(number_points[3] - 1);
+  }
+  for (Face& face : faces.y[1]) {
+    face.valid = false;
+  }
+}
+
+void CorneliusGrid::face_corners(
+    const std::array<
+        std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>,
+        STEPS>& cu,
+    int direction, int side, std::array<double, 8>& corners) {
+  std::array<int, DIM> h;
+  for (int c = 0; c < 8; c++) {
+    int bit = 2;
+    for (int d = 0; d < DIM; d++) {
+      h[d] = (d == direction) ? side : (c >> bit--) & 1;
+    }
+    corners[c] = cu[h[0]][h[1]][h[2]][h[3]];
+  }
+}
+
+const std::array<double, CorneliusGrid::DIM>* CorneliusGrid::match_face(
+    const Face& face, const std::array<double, 8>& corners) {
+  return (face.valid && face.corners == corners) ? &face.centroid : nullptr;
+}
+
+const std::array<double, CorneliusGrid::DIM>* CorneliusGrid::find_time_face(
+    const FaceRef& face_ref, int time_index,
+    const std::array<double, 8>& corners) {
+  if (face_ref.time_index != time_index ||
+      face_ref.thread_index >= static_cast<int>(thread_faces.size())) {
+    return nullptr;
+  }
+  const TimeFaces& owner = thread_faces[face_ref.thread_index];
+  if (face_ref.index >= owner.number_faces[time_index & 1]) {
+    return nullptr;
+  }
+  return match_face(owner.faces[time_index & 1][face_ref.index], corners);
+}
+
+void CorneliusGrid::store_time_face(FaceRef& face_ref, int time_index,
+                                    int thread_index,
+                                    const std::array<double, 8>& corners,
+                                    const std::array<double, DIM>& centroid) {
+  TimeFaces& owner = thread_faces[thread_index];
+  std::vector<Face>& faces = owner.faces[time_index & 1];
+  int& number_faces = owner.number_faces[time_index & 1];
+  if (number_faces == static_cast<int>(faces.size())) {
+    faces.emplace_back();
+  }
+  Face& face = faces[number_faces];
+  face.corners = corners;
+  face.centroid = centroid;
+  face.valid = true;
+  face_ref = {time_index, thread_index, number_faces++};
+}
+
+int CorneliusGrid::get_cell_index(int index_surface_element, int direction) {
+  if (index_surface_element >= get_number_elements() ||
+      direction >= grid_dimension) {
+    throw std::out_of_range(
+        "CorneliusGrid error: asking for an element which does not exist.");
+  }
+  return elements.cells[direction][index_surface_element];
+}
+
+double CorneliusGrid::get_centroid_element(int index_surface_element,
+                                           int element_centroid) {
+  if (index_surface_element >= get_number_elements() ||
+      element_centroid >= grid_dimension) {
+    throw std::out_of_range(
+        "CorneliusGrid error: asking for an element which does not exist.");
+  }
+  return elements.centroids[element_centroid][index_surface_element];
+}
+
+double CorneliusGrid::get_normal_element(int index_surface_element,
+                                         int element_normal) {
+  if (index_surface_element >= get_number_elements() ||
+      element_normal >= grid_dimension) {
+    throw std::out_of_range(
+        "CorneliusGrid error: asking for an element which does not exist.");
+  }
+  return elements.normals[element_normal][index_surface_element];
+}
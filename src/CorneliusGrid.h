@@ -0,0 +1,678 @@
+#ifndef CORNELIUS_GRID_H
+#define CORNELIUS_GRID_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Cornelius.h"
+#include "CubeBatch.h"
+#include "SliceRange.h"
+
+/**
+ * @class CorneliusGrid
+ * @brief Finds the constant value surface on a whole 3D or 4D lattice.
+ *
+ * The field is given as one contiguous buffer in row-major order, i.e. for a
+ * 4D lattice with (n_tau, n_x, n_y, n_z) points the value at (i, j, k, l) is
+ * stored at field[((i * n_x + j) * n_y + k) * n_z + l]. The 3D case uses
+ * (tau, x, y) in the same way. Every lattice cell, i.e. every 2^d block of
+ * neighbouring points, is handed to a Cornelius engine and the surface
+ * elements are collected together with the index of the cell they belong to.
+ *
+ * The lattice can be searched by several threads. The work is split into
+ * tiles, one tile for each row of cells with the same time index and the same
+ * index in the first spatial direction, and the threads take the next free
+ * tile as soon as they are done with the previous one. Since the surface
+ * usually covers only a thin shell of the lattice, this keeps all threads
+ * busy even if most tiles are empty. Each thread owns its own Cornelius
+ * engine and result buffers, and the tiles are merged in lattice order
+ * afterwards, so the results do not depend on the number of threads.
+ *
+ * The centroids are given relative to the first lattice point, so the
+ * absolute position is obtained by adding the position of the point
+ * (0,0,0) or (0,0,0,0) of the lattice.
+ *
+ */
+class CorneliusGrid {
+ public:
+  /**
+   * @brief Work done by one thread during the last search.
+   */
+  struct ThreadLoad {
+    int tiles;       ///< Number of tiles searched
+    long cells;      ///< Number of cells searched
+    long elements;   ///< Number of surface elements found
+    double seconds;  ///< Time spent on the search
+  };
+
+ private:
+  static constexpr int STEPS = 2; /**< Number of steps for the discretization */
+  static constexpr int DIM = 4;   /**< Dimension of the space (default is 4D) */
+
+  /**
+   * @brief Surface elements found by one thread or on the whole lattice.
+   *
+   * The components are stored in separate arrays, i.e. normals[mu][i] is the
+   * component mu of the normal of the element i. Only the first dimension
+   * arrays are used, so 3D lattices keep no column of zeros.
+   */
+  struct Elements {
+    std::array<std::vector<int>, DIM> cells;         ///< Cell indices
+    std::array<std::vector<double>, DIM> normals;    ///< Normal vectors
+    std::array<std::vector<double>, DIM> centroids;  ///< Centroids
+    int dimension = DIM;  ///< Number of components of each element
+
+    /**
+     * @brief Discards all elements and sets the number of components.
+     *
+     * @param new_dimension The dimension of the lattice (3 or 4).
+     */
+    inline void init_elements(int new_dimension) {
+      dimension = DIM;
+      clear();
+      dimension = new_dimension;
+    }
+
+    /**
+     * @brief Gets the number of elements.
+     *
+     * @return The number of elements.
+     */
+    inline std::size_t size() const { return cells[0].size(); }
+
+    /**
+     * @brief Changes the number of elements.
+     *
+     * @param number_elements The new number of elements.
+     */
+    inline void resize(std::size_t number_elements) {
+      for (int i = 0; i < dimension; i++) {
+        cells[i].resize(number_elements);
+        normals[i].resize(number_elements);
+        centroids[i].resize(number_elements);
+      }
+    }
+
+    /**
+     * @brief Discards all elements.
+     */
+    inline void clear() { resize(0); }
+  };
+
+  /**
+   * @brief Position of the elements of one tile in the thread buffers.
+   */
+  struct TileRange {
+    int thread_index;    ///< Thread which has searched the tile
+    std::size_t begin;   ///< First element of the tile in the thread buffer
+    std::size_t end;     ///< One past the last element of the tile
+    std::size_t offset;  ///< First element of the tile in the results
+  };
+
+  /**
+   * @brief Two consecutive time slices of the lattice.
+   */
+  struct Slab {
+    const double* slice0;  ///< Values at the earlier time slice
+    const double* slice1;  ///< Values at the later time slice
+    int time_index;        ///< Lattice index of the earlier time slice
+    double tau0;           ///< Time of the earlier time slice
+    double dt;             ///< Time step between the slices
+    const SliceRange* range0;  ///< Value ranges of the earlier time slice
+    const SliceRange* range1;  ///< Value ranges of the later time slice
+  };
+
+  /**
+   * @brief Cut points on the lattice edges of one row of cells.
+   *
+   * The row j of a slab lies between the planes of lattice points with the
+   * index j and j + 1 in the first spatial direction. For both planes the
+   * cuts on the edges within the plane are stored, and the planes are
+   * rolled over when the same thread searches the row j + 1 next, so each
+   * edge is cut only once instead of once for every cell it belongs to.
+   * Edges which are not cut hold NaN. The points of a plane are indexed by
+   * k * n_z + l in 4D and by k in 3D.
+   */
+  struct EdgeCuts {
+    std::array<std::vector<double>, STEPS>
+        time;  ///< Edges in time direction, for each plane
+    std::array<std::array<std::vector<double>, STEPS>, STEPS>
+        y;  ///< Edges in second spatial direction, for each plane and slice
+    std::array<std::array<std::vector<double>, STEPS>, STEPS>
+        z;  ///< Edges in third spatial direction, for each plane and slice
+    std::array<std::vector<double>, STEPS>
+        x;                  ///< Edges between the planes, for each slice
+    const Slab* slab;       ///< Slab of the stored planes
+    int row;                ///< Row of the stored planes
+    int lower;              ///< Which of the two planes is the plane j
+  };
+
+  /**
+   * @brief Cells of 3D slabs whose elements are found together.
+   *
+   * A place in the result buffer is reserved for the element of each cell
+   * when the cell is added, and it is filled when the batch is done.
+   */
+  struct PendingCells {
+    CubeBatch batch;                 ///< Cells waiting for their elements
+    std::vector<std::size_t> slots;  ///< Reserved element of each cell
+    double tau0;                     ///< Time of the slab of the cells
+  };
+
+  /**
+   * @brief Centroid of the polygon on the upper face of a 4D cell in one
+   * direction, kept for the next cell in that direction.
+   */
+  struct Face {
+    std::array<double, 8> corners;     ///< Values at the corners of the face
+    std::array<double, DIM> centroid;  ///< Centroid of the polygon
+    bool valid = false;                ///< Flag for a stored centroid
+  };
+
+  /**
+   * @brief Time faces stored by one thread.
+   *
+   * The faces of the slabs with even and odd time index are kept apart, so
+   * the faces of the previous slab can be read while the faces of the
+   * current slab are stored.
+   */
+  struct TimeFaces {
+    std::array<std::vector<Face>, STEPS>
+        faces;  ///< Faces for even and odd time indices
+    std::array<int, STEPS> number_faces = {0, 0};  ///< Faces in use
+  };
+
+  /**
+   * @brief Spatial faces stored by one thread while it searches a row.
+   *
+   * For each direction the faces of the previous and of the current cells
+   * are kept, and the roles are swapped when the thread moves on. The faces
+   * of a row are kept for the next row if the same thread searches it next,
+   * in the same way as the edge cuts. The stored faces always belong to the
+   * neighbouring cell in the same slab, so their corners are not compared.
+   */
+  struct SpaceFaces {
+    std::array<std::vector<Face>, STEPS>
+        x;  ///< Faces of two rows, indexed by k * (n_z - 1) + l
+    std::array<std::vector<Face>, STEPS>
+        y;  ///< Faces of two lines of cells with fixed k, indexed by l
+    std::array<Face, STEPS> z;  ///< Faces of two cells
+    const Slab* slab;           ///< Slab of the stored rows
+    int row;                    ///< Row stored last
+    int lower;                  ///< Which of the two rows is the row j - 1
+  };
+
+  /**
+   * @brief Position of the time face of one spatial cell.
+   */
+  struct FaceRef {
+    int time_index;    ///< Time index of the slab which stored the face
+    int thread_index;  ///< Thread which has stored the face
+    int index;         ///< Index of the face in the thread storage
+  };
+
+  int grid_dimension; /**< Dimension of the lattice (3 or 4) */
+  bool initialized;   /**< Flag to indicate if the grid has been initialized */
+  double value;       /**< Threshold value for surface detection */
+  int number_threads; /**< Number of threads used for the search */
+  std::array<double, DIM> dx; /**< Lattice spacing in each dimension */
+  std::array<int, DIM>
+      number_points; /**< Number of lattice points in each dimension */
+
+  std::vector<std::unique_ptr<Cornelius>>
+      engines; /**< Engines used for the individual cells, one per thread */
+  std::vector<Elements>
+      thread_elements;     /**< Elements found by each of the threads */
+  std::vector<EdgeCuts> thread_cuts; /**< Edge cuts of each thread */
+  std::vector<PendingCells>
+      thread_pending; /**< Batched 3D cells of each of the threads */
+  std::vector<std::vector<int>>
+      thread_patterns; /**< Corner patterns of the row of each thread */
+  std::vector<TimeFaces>
+      thread_faces; /**< Time faces stored by each of the threads */
+  std::vector<SpaceFaces>
+      thread_space_faces; /**< Spatial faces of each of the threads */
+  std::vector<FaceRef>
+      face_refs; /**< Time face of each spatial cell, for 4D slabs */
+  bool reuse_time_faces; /**< Flag to hand time faces from slab to slab */
+  std::vector<ThreadLoad> loads; /**< Work done by each of the threads */
+  Elements elements;             /**< Elements found on the lattice */
+  std::vector<Slab> slabs;       /**< Slabs which are searched next */
+  std::vector<TileRange> tiles;  /**< Elements of each tile of the slabs */
+  std::atomic<std::size_t> next_tile; /**< Next tile which is not taken */
+  std::vector<SliceRange>
+      slice_ranges; /**< Value ranges of the slices built by the grid */
+  std::vector<const double*>
+      range_slices; /**< Slices whose ranges are built next */
+  std::atomic<std::size_t>
+      next_range; /**< Next slice whose range is not taken */
+  std::vector<std::thread>
+      workers; /**< Worker threads with the thread indices 1, 2, ... */
+  std::mutex pool_mutex; /**< Guards the hand-off of work to the workers */
+  std::condition_variable
+      pool_start; /**< Wakes the workers when there is new work */
+  std::condition_variable
+      pool_done; /**< Wakes the caller when the workers are done */
+  void (CorneliusGrid::*pool_work)(int); /**< Work of the current round */
+  int pool_threads_used; /**< Threads which take part in the current round */
+  int pool_running;      /**< Workers which are still busy in the round */
+  long pool_round;       /**< Number of rounds handed out so far */
+  bool pool_stop;        /**< Flag which tells the workers to exit */
+
+  /**
+   * @brief Searches all slabs in the slab list and appends the elements to
+   * the results.
+   *
+   * The threads take the tiles of the slabs one at a time until all tiles
+   * are done. The offsets of the tiles in the results follow from a prefix
+   * sum over the number of elements in each tile, and the threads then copy
+   * their elements in place, so no locks are needed.
+   */
+  void scan_slabs();
+
+  /**
+   * @brief Builds the value ranges of the slices in range_slices into
+   * slice_ranges.
+   *
+   * The ranges of all slices are built with several threads before the
+   * search, so each slice is read once even if it belongs to two slabs.
+   */
+  void build_slice_ranges();
+
+  /**
+   * @brief Takes slices from range_slices and builds their ranges until no
+   * slice is left.
+   *
+   * @param thread_index Index of the thread.
+   */
+  void scan_ranges(int thread_index);
+
+  /**
+   * @brief Runs a member function on several threads.
+   *
+   * The calling thread runs the function with thread index zero, and the
+   * workers started by set_number_threads() run it with the other indices.
+   * The function returns when all threads are done.
+   *
+   * @param threads_used Number of threads, at most the number of threads.
+   * @param work Function which is called with the index of the thread.
+   */
+  void run_threads(int threads_used, void (CorneliusGrid::*work)(int));
+
+  /**
+   * @brief Waits for work handed out by run_threads() until the workers are
+   * stopped.
+   *
+   * @param thread_index Index of the worker thread.
+   * @param round The last round handed out before the worker was started.
+   * It is passed in, so the worker cannot miss a round handed out before it
+   * gets to wait.
+   */
+  void worker_loop(int thread_index, long round);
+
+  /**
+   * @brief Stops and joins all worker threads.
+   */
+  void stop_workers();
+
+  /**
+   * @brief Takes tiles of the slab list and searches them until no tile is
+   * left.
+   *
+   * A tile contains all cells of a slab with the same index in the first
+   * spatial direction.
+   *
+   * @param thread_index Index of the thread, which selects the engine, the
+   * result buffer and the load record.
+   */
+  void scan_tiles(int thread_index);
+
+  /**
+   * @brief Copies the elements of the tiles searched by one thread to their
+   * place in the results.
+   *
+   * The offsets of the tiles must be set before.
+   *
+   * @param thread_index Index of the thread whose tiles are copied.
+   */
+  void copy_tiles(int thread_index);
+
+  /**
+   * @brief Copies the elements found by an engine for one cell into a result
+   * buffer.
+   *
+   * @param engine Engine which has searched the cell.
+   * @param cell Lattice index of the cell, padded in the same way as the
+   * dx array, i.e. the last DIM - grid_dimension entries are not used.
+   * @param tau0 Time of the lower time face of the cell.
+   * @param found Buffer to which the elements are appended.
+   */
+  void collect_elements(Cornelius& engine, const std::array<int, DIM>& cell,
+                        double tau0, Elements& found);
+
+  /**
+   * @brief Cuts the edges within one plane of lattice points of a slab.
+   *
+   * @param cuts Buffer in which the cuts are stored.
+   * @param slab Slab the plane belongs to.
+   * @param j Index of the plane in the first spatial direction.
+   * @param plane Which of the two planes of the buffer is filled.
+   */
+  void cut_plane(EdgeCuts& cuts, const Slab& slab, int j, int plane);
+
+  /**
+   * @brief Provides the cuts on all edges of one row of cells.
+   *
+   * The plane j + 1 of the previous row is reused if the buffer holds the
+   * row j - 1 of the same slab.
+   *
+   * @param cuts Buffer in which the cuts are stored.
+   * @param slab Slab the row belongs to.
+   * @param j Index of the row in the first spatial direction.
+   */
+  void cut_row(EdgeCuts& cuts, const Slab& slab, int j);
+
+  /**
+   * @brief Finds the corner pattern of every cell of one row.
+   *
+   * This is the first of the two passes over a row. The bit of a corner is
+   * set if the value at the corner is at or above the value, with the
+   * corners numbered as in Cube::CubeCase in 3D and as in Hypercube in 4D.
+   * Cells which are not crossed by the surface get the pattern zero, so the
+   * second pass copies the corners of the crossed cells only.
+   *
+   * The value ranges of the slab are looked up first, and a row or a line of
+   * cells which cannot be crossed is skipped. Otherwise the packed sign bits
+   * of the four or eight lines of points holding the corners are combined a
+   * word at a time, which marks the crossed cells among 64 cells with a few
+   * word operations. Only the patterns of these cells are gathered from the
+   * bits.
+   *
+   * @param slab Slab the row belongs to.
+   * @param j Index of the row in the first spatial direction.
+   * @param patterns Buffer for the patterns, indexed by k in 3D and by
+   * k * (n_z - 1) + l in 4D.
+   * @return The number of cells crossed by the surface.
+   */
+  int classify_row(const Slab& slab, int j, std::vector<int>& patterns);
+
+  /**
+   * @brief Goes through all cells of one row of a 3D slab.
+   *
+   * The cells which CubeBatch can take are only queued, and their elements
+   * are filled in by flush_cells(). The batch groups the cells by their
+   * pattern, so the cells of one pattern are handled together no matter
+   * where they lie. The other cells are handed to the engine.
+   *
+   * @param engine Engine used for the cells.
+   * @param slab Slab the row belongs to.
+   * @param j Index of the row in the first spatial direction.
+   * @param cuts Cuts on the edges of the row.
+   * @param patterns Corner patterns of the cells from classify_row().
+   * @param pending Batch to which the cells are added.
+   * @param found Buffer to which the elements are appended.
+   */
+  void row_3d(Cornelius& engine, const Slab& slab, int j,
+              const EdgeCuts& cuts, const std::vector<int>& patterns,
+              PendingCells& pending, Elements& found);
+
+  /**
+   * @brief Finds the elements of the batched 3D cells and writes them to
+   * their reserved places. The batch is empty afterwards.
+   *
+   * @param pending Batched cells.
+   * @param found Buffer which holds the reserved elements.
+   */
+  void flush_cells(PendingCells& pending, Elements& found);
+
+  /**
+   * @brief Goes through all cells of one row of a 4D slab.
+   *
+   * The centroids of the polygons on the upper faces of each cell are
+   * stored and handed to the engine for the lower faces of the next cells in
+   * the spatial directions. If time faces are reused, the same is done in
+   * time from one slab to the next.
+   *
+   * @param engine Engine used for the cells.
+   * @param slab Slab the row belongs to.
+   * @param j Index of the row in the first spatial direction.
+   * @param cuts Cuts on the edges of the row.
+   * @param patterns Corner patterns of the cells from classify_row().
+   * @param thread_index Index of the thread searching the row.
+   * @param found Buffer to which the elements are appended.
+   */
+  void row_4d(Cornelius& engine, const Slab& slab, int j,
+              const EdgeCuts& cuts, const std::vector<int>& patterns,
+              int thread_index, Elements& found);
+
+  /**
+   * @brief Prepares the spatial faces of a thread for one row of cells.
+   *
+   * The faces of the previous row are kept if the thread has searched the
+   * row j - 1 of the same slab just before, otherwise they are discarded.
+   *
+   * @param faces Faces of the thread.
+   * @param slab Slab the row belongs to.
+   * @param j Index of the row in the first spatial direction.
+   */
+  void roll_space_faces(SpaceFaces& faces, const Slab& slab, int j);
+
+  /**
+   * @brief Gets the values at the corners of one face of a 4D cell.
+   *
+   * @param cu Values at the corners of the cell.
+   * @param direction Direction normal to the face.
+   * @param side Zero for the lower and one for the upper face.
+   * @param corners Values at the corners of the face, ordered as the corners
+   * of the cube with the remaining directions.
+   */
+  static void face_corners(
+      const std::array<
+          std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>,
+          STEPS>& cu,
+      int direction, int side, std::array<double, 8>& corners);
+
+  /**
+   * @brief Checks if a stored face matches the lower face of a cell.
+   *
+   * @param face Stored face.
+   * @param corners Values at the lower face of the cell.
+   * @return Pointer to the centroid of the face, or a null pointer if no
+   * matching centroid is stored.
+   */
+  static const std::array<double, DIM>* match_face(const Face& face,
+                                   const std::array<double, 8>& corners);
+
+  /**
+   * @brief Looks up the time face stored for a spatial cell by the previous
+   * slab.
+   *
+   * @param face_ref Reference of the cell.
+   * @param time_index Time index of the previous slab.
+   * @param corners Values at the earlier time face of the cell.
+   * @return Pointer to the centroid of the face, or a null pointer if no
+   * matching face is stored.
+   */
+  const std::array<double, DIM>* find_time_face(
+      const FaceRef& face_ref, int time_index,
+      const std::array<double, 8>& corners);
+
+  /**
+   * @brief Stores the centroid of the polygon on the later time face of a
+   * cell for the next slab.
+   *
+   * @param face_ref Reference of the cell, which is set to the stored face.
+   * @param time_index Time index of the slab.
+   * @param thread_index Index of the thread storing the face.
+   * @param corners Values at the later time face of the cell.
+   * @param centroid Centroid of the polygon on the face.
+   */
+  void store_time_face(FaceRef& face_ref, int time_index, int thread_index,
+                       const std::array<double, 8>& corners,
+                       const std::array<double, DIM>& centroid);
+
+ public:
+  /**
+   * @brief Default constructor for the CorneliusGrid class.
+   */
+  CorneliusGrid();
+
+  /**
+   * @brief Destructor for the CorneliusGrid class.
+   */
+  ~CorneliusGrid();
+
+  /**
+   * @brief Initializes the lattice.
+   *
+   * @param dimension The dimension of the lattice (3 or 4).
+   * @param new_value The value for surface.
+   * @param new_number_points Number of lattice points in each direction. Must
+   * contain as many elements as the dimension of the problem (n1,n2,...),
+   * each at least two.
+   * @param new_dx Lattice spacing. Must contain as many elements as the
+   * dimension of the problem (dx1,dx2,...).
+   */
+  void init_grid(int dimension, double new_value,
+                 std::array<int, DIM>& new_number_points,
+                 std::array<double, DIM>& new_dx);
+
+  /**
+   * @brief Sets the number of threads used for the search.
+   *
+   * The worker threads are started here and kept until the number of
+   * threads changes or the grid is destroyed, so every search reuses them.
+   *
+   * @param new_number_threads Number of threads. Values smaller than one use
+   * all hardware threads of the machine.
+   */
+  void set_number_threads(int new_number_threads);
+
+  /**
+   * @brief Gets the number of threads used for the search.
+   *
+   * @return The number of threads.
+   */
+  inline int get_number_threads() { return number_threads; }
+
+  /**
+   * @brief Gets the work done by one thread during the last search.
+   *
+   * @param thread_index The index of the thread. Valid values are
+   *               [0,number of threads).
+   * @return The number of tiles, cells and elements and the time spent by
+   * the thread.
+   */
+  const ThreadLoad& get_thread_load(int thread_index);
+
+  /**
+   * @brief Finds all surface elements on the lattice.
+   *
+   * The results of a previous call are discarded.
+   *
+   * @param field Values at the lattice points in row-major order.
+   */
+  void find_surface(const double* field);
+
+  /**
+   * @brief Finds the surface elements between two consecutive time slices and
+   * appends them to the results.
+   *
+   * A slice contains all points with the same time index, stored in the same
+   * row-major order as the full field. The number of points in the time
+   * direction given to init_grid() is not used here.
+   *
+   * In 4D, the centroids of the polygons on the later time faces of the
+   * cells are kept, and
+   * if the next call continues with time_index + 1 and the same values on
+   * that slice, they are reused for the earlier time faces.
+   *
+   * @param slice0 Values at the earlier time slice.
+   * @param slice1 Values at the later time slice.
+   * @param time_index Index of the earlier time slice, stored as the time
+   * index of the cells.
+   * @param tau0 Time of the earlier time slice. The time component of the
+   * centroids is given relative to the same origin.
+   * @param dt Time step between the two slices.
+   */
+  void append_slab(const double* slice0, const double* slice1, int time_index,
+                   double tau0, double dt);
+
+  /**
+   * @brief Finds the surface elements between two consecutive time slices
+   * whose value ranges are already known, and appends them to the results.
+   *
+   * Rows and parts of rows whose corners are all below or all at or above
+   * the value are skipped with the ranges. A caller which keeps the range of
+   * a slice for the next time step builds each range only once.
+   *
+   * @param slice0 Values at the earlier time slice.
+   * @param slice1 Values at the later time slice.
+   * @param time_index Index of the earlier time slice.
+   * @param tau0 Time of the earlier time slice.
+   * @param dt Time step between the two slices.
+   * @param range0 Value ranges of the earlier time slice.
+   * @param range1 Value ranges of the later time slice.
+   */
+  void append_slab(const double* slice0, const double* slice1, int time_index,
+                   double tau0, double dt, const SliceRange& range0,
+                   const SliceRange& range1);
+
+  /**
+   * @brief Discards all surface elements found so far.
+   */
+  inline void clear_elements() { elements.clear(); }
+
+  /**
+   * @brief Gets the number of surface elements found.
+   *
+   * @return The number of surface elements.
+   */
+  inline int get_number_elements() {
+    return static_cast<int>(elements.size());
+  }
+
+  /**
+   * @brief Gets the lattice index of the cell of a surface element.
+   *
+   * @param index_surface_element The index of the surface element.
+   * @param direction The direction of the index. Valid values are
+   *               [0,dimension of the problem].
+   * @return The index of the lower corner of the cell in this direction.
+   */
+  int get_cell_index(int index_surface_element, int direction);
+
+  /**
+   * @brief Gets a specific centroid element relative to the first lattice
+   * point.
+   *
+   * @param index_surface_element The index of the surface element.
+   * @param element_centroid The index of the centroid element. Valid values are
+   *               [0,dimension of the problem].
+   * @return The value of the specified centroid element.
+   */
+  double get_centroid_element(int index_surface_element, int element_centroid);
+
+  /**
+   * @brief Gets a specific normal element.
+   *
+   * @param index_surface_element The index of the surface element.
+   * @param element_normal The index of the normal element. Valid values are
+   *               [0,dimension of the problem].
+   * @return The value of the specified normal element.
+   */
+  double get_normal_element(int index_surface_element, int element_normal);
+};
+
+#endif  // CORNELIUS_GRID_H
@@ -0,0 +1,62 @@
+#include "CorneliusStream.h"
+
+CorneliusStream::CorneliusStream()
+    : initialized(false),
+      value(0),
+      number_slices(0),
+      tau_previous(0),
+      slice_size(0),
+      range_previous(0) {}
+
+CorneliusStream::~CorneliusStream() = default;
+
+void CorneliusStream::init_stream(double new_value,
+                                  std::array<int, SPACE_DIM>& new_number_points,
+                                  std::array<double, SPACE_DIM>& new_dx) {
+  // The number of points and the step in the time direction are set for each
+  // time step separately
+  std::array<int, DIM> number_points = {STEPS, new_number_points[0],
+                                        new_number_points[1],
+                                        new_number_points[2]};
+  std::array<double, DIM> dx = {0.0, new_dx[0], new_dx[1], new_dx[2]};
+  grid.init_grid(DIM, new_value, number_points, dx);
+  value = new_value;
+
+  slice_size = 1;
+  for (int i = 0; i < SPACE_DIM; i++) {
+    slice_size *= new_number_points[i];
+  }
+  previous.assign(slice_size, 0.0);
+  for (SliceRange& range : ranges) {
+    range.init_slice_range(new_number_points[0], new_number_points[1],
+                           new_number_points[2]);
+  }
+  number_slices = 0;
+  initialized = true;
+}
+
+void CorneliusStream::push_slice(double tau, const double* field) {
+  if (!initialized) {
+    std::cerr << "CorneliusStream not initialized." << std::endl;
+    exit(1);
+  }
+  // A time step which is zero or negative would flip the surface
+  if (number_slices > 0 && !(tau > tau_previous)) {
+    std::cerr << "CorneliusStream error: the time of a slice must be larger "
+                 "than the time of the previous slice."
+              << std::endl;
+    exit(1);
+  }
+  grid.clear_elements();
+  const int range_current = range_previous ^ 1;
+  ranges[range_current].build(field, value);
+  if (number_slices > 0) {
+    grid.append_slab(previous.data(), field, number_slices - 1, tau_previous,
+                     tau - tau_previous, ranges[range_previous],
+                     ranges[range_current]);
+  }
+  std::copy(field, field + slice_size, previous.begin());
+  range_previous = range_current;
+  tau_previous = tau;
+  number_slices++;
+}
@@ -0,0 +1,149 @@
+#ifndef CORNELIUS_STREAM_H
+#define CORNELIUS_STREAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "CorneliusGrid.h"
+
+/**
+ * @class CorneliusStream
+ * @brief Finds the surface of a 3+1D evolution one time step at a time.
+ *
+ * The spatial slices (x,y,z) are pushed one after the other with
+ * push_slice(). As soon as a slice arrives, the hypercubes between it and
+ * the previous slice are searched for surface elements, which can be read out
+ * before the next slice is pushed. Only a copy of the previous slice is kept,
+ * so the memory does not grow with the length of the evolution.
+ *
+ * The value ranges and sign bits which let the search skip the parts of a
+ * time step away from the surface are built once for each slice when it is
+ * pushed, and kept together with the copy for the next time step.
+ *
+ * The time component of the centroids is the absolute time, the spatial
+ * components are given relative to the first lattice point.
+ *
+ */
+class CorneliusStream {
+ private:
+  static constexpr int STEPS = 2;     /**< Number of slices in a time step */
+  static constexpr int DIM = 4;       /**< Dimension of the space */
+  static constexpr int SPACE_DIM = 3; /**< Dimension of a slice */
+
+  bool initialized;             /**< Flag for the initialization */
+  double value;                 /**< Value of the surface */
+  int number_slices;            /**< Number of slices pushed so far */
+  double tau_previous;          /**< Time of the previous slice */
+  std::size_t slice_size;       /**< Number of points in one slice */
+  std::vector<double> previous; /**< Copy of the previous slice */
+  std::array<SliceRange, STEPS>
+      ranges;         /**< Value ranges of the previous and the new slice */
+  int range_previous; /**< Which of the ranges belongs to the previous slice */
+
+  CorneliusGrid grid; /**< Lattice engine used for the time slabs */
+
+ public:
+  /**
+   * @brief Default constructor for the CorneliusStream class.
+   */
+  CorneliusStream();
+
+  /**
+   * @brief Destructor for the CorneliusStream class.
+   */
+  ~CorneliusStream();
+
+  /**
+   * @brief Initializes the stream.
+   *
+   * @param new_value The value for surface.
+   * @param new_number_points Number of lattice points in the (x,y,z)
+   * directions.
+   * @param new_dx Lattice spacing in the (x,y,z) directions.
+   */
+  void init_stream(double new_value,
+                   std::array<int, SPACE_DIM>& new_number_points,
+                   std::array<double, SPACE_DIM>& new_dx);
+
+  /**
+   * @brief Sets the number of threads used to search a time step.
+   *
+   * @param new_number_threads Number of threads. Values smaller than one use
+   * all hardware threads of the machine.
+   */
+  inline void set_number_threads(int new_number_threads) {
+    grid.set_number_threads(new_number_threads);
+  }
+
+  /**
+   * @brief Adds the next time slice and finds the surface elements between it
+   * and the previous slice.
+   *
+   * The elements of the previous time step are discarded. Nothing is found
+   * for the first slice. The field is copied, so the buffer can be reused by
+   * the caller as soon as this function returns.
+   *
+   * @param tau Time of the slice. Must be larger than the time of the
+   * previous slice, otherwise the program exits with an error.
+   * @param field Values at the lattice points of the slice in row-major
+   * order.
+   */
+  void push_slice(double tau, const double* field);
+
+  /**
+   * @brief Gets the number of slices pushed so far.
+   *
+   * @return The number of slices.
+   */
+  inline int get_number_slices() { return number_slices; }
+
+  /**
+   * @brief Gets the number of surface elements found in the last time step.
+   *
+   * @return The number of surface elements.
+   */
+  inline int get_number_elements() { return grid.get_number_elements(); }
+
+  /**
+   * @brief Gets the lattice index of the cell of a surface element. The time
+   * index counts the pushed slices starting from zero.
+   *
+   * @param index_surface_element The index of the surface element.
+   * @param direction The direction of the index. Valid values are [0,3].
+   * @return The index of the lower corner of the cell in this direction.
+   */
+  inline int get_cell_index(int index_surface_element, int direction) {
+    return grid.get_cell_index(index_surface_element, direction);
+  }
+
+  /**
+   * @brief Gets a specific centroid element.
+   *
+   * @param index_surface_element The index of the surface element.
+   * @param element_centroid The index of the centroid element. Valid values are
+   *               [0,3].
+   * @return The value of the specified centroid element.
+   */
+  inline double get_centroid_element(int index_surface_element,
+                                     int element_centroid) {
+    return grid.get_centroid_element(index_surface_element, element_centroid);
+  }
+
+  /**
+   * @brief Gets a specific normal element.
+   *
+   * @param index_surface_element The index of the surface element.
+   * @param element_normal The index of the normal element. Valid values are
+   *               [0,3].
+   * @return The value of the specified normal element.
+   */
+  inline double get_normal_element(int index_surface_element,
+                                   int element_normal) {
+    return grid.get_normal_element(index_surface_element, element_normal);
+  }
+};
+
+#endif  // CORNELIUS_STREAM_H
@@ -1,8 +1,20 @@
 #include "Cube.h"
 
-Cube::Cube() : number_lines(0), number_polygons(0), ambiguous(false) {
-  polygons.reserve(MAX_POLYGONS);
-  polygons.emplace_back();  // Default to construct 1 Polygon
+const std::array<Cube::CubeCase, Cube::NCASES> Cube::cases =
+    Cube::build_cases();
+
+const std::array<std::array<int, 2>, Cube::NEDGES> Cube::edge_corners =
+    Cube::build_edge_corners();
+
+Cube::Cube()
+    : given_squares(nullptr),
+      number_lines(0),
+      ambiguous(false),
+      given_cuts(nullptr),
+      edge_cuts(nullptr) {
+  for (int i = 0; i < NSQUARES; i++) {
+    square_refs[i] = &squares[i];
+  }
 }
 
 Cube::~Cube() = default;
@@ -38,7 +50,8 @@ void Cube::init_cube(
     default:
       break;
   }
-  number_lines = number_polygons = 0;
+  number_lines = 0;
+  polygons.clear();
   ambiguous = false;
 }
 
@@ -67,15 +80,168 @@ void Cube::split_to_squares() {
 }
 
 void Cube::construct_polygons(double value) {
-  // Start by splitting the cube to squares and finding the lines
-  split_to_squares();
+  int pattern = 0;
+  for (int c = 0; c < NCORNERS; c++) {
+    if (cube[c >> 2][(c >> 1) & 1][c & 1] >= value) {
+      pattern |= 1 << c;
+    }
+  }
+  const CubeCase& cube_case = cases[pattern];
+  if (pattern == 0 || pattern == NCASES - 1) {
+    number_lines = 0;
+    return;
+  }
+  // Cut all edges at once, the polygons are then built from the cuts
+  find_edge_cuts(value);
+  if (!cube_case.ambiguous && construct_polygon_from_case(cube_case, value)) {
+    return;
+  }
+  number_lines = 0;
+  polygons.clear();
+  construct_polygons_from_squares(value);
+}
+
+void Cube::find_edge_cuts(double value) {
+  if (given_cuts != nullptr) {
+    edge_cuts = given_cuts;
+    return;
+  }
+  // Gather the corners of the edges, so that all edges are cut in one loop
+  const std::array<int, 3> x = {x1, x2, x3};
+  std::array<double, NEDGES> values_low;
+  std::array<double, NEDGES> values_high;
+  std::array<double, NEDGES> delta_x;
+  for (int edge = 0; edge < NEDGES; edge++) {
+    const int low = edge_corners[edge][0];
+    const int high = edge_corners[edge][1];
+    values_low[edge] = cube[low >> 2][(low >> 1) & 1][low & 1];
+    values_high[edge] = cube[high >> 2][(high >> 1) & 1][high & 1];
+    delta_x[edge] = dx[x[edge / 4]];
+  }
+  Square::edge_cuts(NEDGES, values_low.data(), values_high.data(), value,
+                    delta_x.data(), cut_values.data());
+  edge_cuts = cut_values.data();
+}
+
+bool Cube::cut_edge(int edge) {
+  const int direction = edge / 4;
+  const std::array<int, 3> x = {x1, x2, x3};
+  const int low = edge_corners[edge][0];
+  const double cut = edge_cuts[edge];
+  if (std::isnan(cut)) {
+    return false;
+  }
+  auto& point = edge_points[edge];
+  point[const_i] = const_value;
+  for (int d = 0; d < 3; d++) {
+    point[x[d]] = (d == direction)          ? cut
+                  : ((low >> (2 - d)) & 1) ? dx[x[d]]
+                                           : 0;
+  }
+  return true;
+}
+
+bool Cube::construct_polygon_from_case(const CubeCase& cube_case,
+                                       double value) {
+  number_lines = cube_case.number_lines;
+  if (number_lines == 0) {
+    return true;
+  }
+  const std::array<int, 3> x = {x1, x2, x3};
+  int edges_done = 0;
+  std::array<std::array<double, DIM>, STEPS> points_line;
+  std::array<double, DIM> out_line;
+  for (int l = 0; l < number_lines; l++) {
+    const auto& line = cube_case.lines[l];
+    for (int e = 1; e < 3; e++) {
+      if (!(edges_done & (1 << line[e]))) {
+        if (!cut_edge(line[e])) {
+          return false;
+        }
+        edges_done |= 1 << line[e];
+      }
+      points_line[e - 1] = edge_points[line[e]];
+    }
+    // The point outside of the line is the mean of the corners of the
+    // square below the value, as in Square::find_outside()
+    const int fixed = line[0] / 2;
+    const int j = line[0] % 2;
+    const int a = (fixed == 0) ? 1 : 0;
+    const int b = (fixed == 2) ? 1 : 2;
+    double out_a = 0.0;
+    double out_b = 0.0;
+    int number_out = 0;
+    for (int ci1 = 0; ci1 < STEPS; ci1++) {
+      for (int ci2 = 0; ci2 < STEPS; ci2++) {
+        const int c = (j << (2 - fixed)) | (ci1 << (2 - a)) | (ci2 << (2 - b));
+        if (cube[c >> 2][(c >> 1) & 1][c & 1] < value) {
+          out_a += ci1 * dx[x[a]];
+          out_b += ci2 * dx[x[b]];
+          number_out++;
+        }
+      }
+    }
+    out_line[x[a]] = out_a / number_out;
+    out_line[x[b]] = out_b / number_out;
+    out_line[const_i] = const_value;
+    out_line[x[fixed]] = j * dx[x[fixed]];
+    lines[l].init_line(points_line, out_line, {const_i, x[fixed]});
+  }
+
+  // There is only one polygon and all lines can be added to it without
+  // ordering them
+  Polygon& polygon = polygons.push_slot();
+  polygon.init_polygon(const_i);
+  for (int i = 0; i < number_lines; i++) {
+    polygon.add_line(lines[i], true);
+  }
+  return true;
+}
+
+void Cube::construct_polygons_from_squares(double value) {
+  // Start by splitting the cube to squares and finding the lines, unless
+  // the squares are given
+  if (given_squares == nullptr) {
+    split_to_squares();
+    for (int i = 0; i < NSQUARES; i++) {
+      square_refs[i] = &squares[i];
+      for (int local_edge = 0; local_edge < 4; local_edge++) {
+        square_cuts[i][local_edge] =
+            edge_cuts[square_edge_index(i, local_edge)];
+      }
+      squares[i].set_edge_cuts(square_cuts[i].data());
+      squares[i].construct_lines(value);
+    }
+  } else {
+    square_refs = *given_squares;
+  }
 
   // Then we make a table which contains references to the lines
+  const std::array<int, 3> x = {x1, x2, x3};
+  std::array<std::array<double, DIM>, STEPS> points_line;
   number_lines = 0;
   for (int i = 0; i < NSQUARES; i++) {
-    squares[i].construct_lines(value);
-    for (int j = 0; j < squares[i].get_number_lines(); j++) {
-      lines[number_lines++] = squares[i].get_lines()[j];
+    Square& sq = *square_refs[i];
+    for (int j = 0; j < sq.get_number_lines(); j++) {
+      Line& square_line = sq.get_lines()[j];
+      const std::array<int, 2> ends = sq.get_line_edges(j);
+      line_edges[number_lines] = {square_edge_index(i, ends[0]),
+                                  square_edge_index(i, ends[1])};
+      if (given_squares == nullptr) {
+        // The squares belong to this cube, so their lines can be used
+        // without copying them
+        line_refs[number_lines++] = &square_line;
+      } else {
+        // The squares are shared with another cube, which must not see the
+        // lines flipped. The constant index of this cube comes first
+        points_line = {square_line.get_start_point(),
+                       square_line.get_end_point()};
+        lines[number_lines].init_line(points_line,
+                                      square_line.get_outside_point(),
+                                      {const_i, x[i / 2]});
+        line_refs[number_lines] = &lines[number_lines];
+        number_lines++;
+      }
     }
   }
 
@@ -87,47 +253,62 @@ void Cube::construct_polygons(double value) {
   check_ambiguity(number_lines);
   if (ambiguous) {
     // Surface is ambiguous, connect the lines to polygons and see how
-    // many polygons we have
-    std::array<bool, NSQUARES* 2> not_used = {true};
+    // many polygons we have. Every cut edge is shared by exactly two lines,
+    // so the next line of a polygon is the other line on the edge where the
+    // last line ends
+    std::array<std::array<int, 2>, NEDGES> edge_lines;
+    for (auto& pair : edge_lines) {
+      pair = {-1, -1};
+    }
+    for (int i = 0; i < number_lines; i++) {
+      for (int edge : line_edges[i]) {
+        edge_lines[edge][edge_lines[edge][0] < 0 ? 0 : 1] = i;
+      }
+    }
+    std::array<bool, NSQUARES * 2> not_used;
+    not_used.fill(true);
     // Keep track of the lines which are used
     int used = 0;
-    do {
+    int first = 0;
+    while (used < number_lines) {
       if (number_lines - used < 3) {
         std::cerr << "Error: cannot construct polygon from "
                   << number_lines - used << " lines" << std::endl;
         exit(1);
       }
-      // Ensure there's space in the vector
-      if (number_polygons >= polygons.size()) {
-        polygons.emplace_back();  // Add a new Polygon if needed
+      // Initialize a new polygon, starting from the first unused line
+      Polygon& polygon = polygons.push_slot();
+      polygon.init_polygon(const_i);
+      while (!not_used[first]) {
+        first++;
       }
-      // Initialize a new polygon
-      polygons[number_polygons].init_polygon(const_i);
-      // Go through all lines and try to add them to the polygon
-      for (int i = 0; i < number_lines; i++) {
-        // add_line returns true if line is successfully added
-        if (not_used[i] &&
-            polygons[number_polygons].add_line(lines[i], false)) {
-          not_used[i] = false;
-          used++;
-          // If line is successfully added we start the loop from the
-          // beginning
-          i = 0;
+      int i = first;
+      while (i >= 0) {
+        not_used[i] = false;
+        used++;
+        polygon.add_line(*line_refs[i], true);
+        // Follow the edge where the line ends, keeping the start of the
+        // next line connected to it
+        const int edge = line_edges[i][1];
+        const int next = (edge_lines[edge][0] == i) ? edge_lines[edge][1]
+                                                    : edge_lines[edge][0];
+        i = -1;
+        if (next >= 0 && not_used[next]) {
+          if (line_edges[next][1] == edge) {
+            line_refs[next]->flip_start_end();
+            std::swap(line_edges[next][0], line_edges[next][1]);
+          }
+          i = next;
         }
       }
-      // When we have reached this point one complete polygon is formed
-      number_polygons++;
-    } while (used < number_lines);
+    }
   } else {
     // Surface is not ambiguous, so we have only one polygon and all lines
     // can be added to it without ordering them
-    if (number_polygons >= polygons.size()) {
-      polygons.emplace_back();  // Add a new Polygon if needed
-    }
-    polygons[number_polygons].init_polygon(const_i);
+    Polygon& polygon = polygons.push_slot();
+    polygon.init_polygon(const_i);
     for (int i = 0; i < number_lines; i++) {
-      polygons[number_polygons].add_line(lines[i], true);
+      polygon.add_line(*line_refs[i], true);
     }
-    number_polygons++;
   }
 }
\ No newline at end of file
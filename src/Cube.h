@@ -2,9 +2,13 @@
 #define CUBE_H
 
 #include <array>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
+#include "FixedVector.h"
 #include "GeneralGeometryElement.h"
 #include "Line.h"
 #include "Polygon.h"
@@ -20,6 +24,14 @@
  * polygons within the cube, split the cube into squares, and check for
  * ambiguity.
  *
+ * Most cubes are handled with a precomputed table, which is keyed on the
+ * pattern of corners above and below the value. For each of the 256 patterns
+ * it stores which edges are cut and how the cuts are joined into lines, so
+ * only the cut points have to be interpolated. The lines are the same, and
+ * come in the same order, as the ones the squares would construct, so the
+ * results do not change. Ambiguous cubes are split into squares and the
+ * lines are connected as before.
+ *
  * 13.10.2011 Hannu Holopainen
  * 23.08.2024 Hendrik Roch, Haydar Mehryar
  *
@@ -29,17 +41,161 @@ class Cube : public GeneralGeometryElement {
   static constexpr int DIM = 4;           ///< Dimension of the space.
   static constexpr int CUBE_DIM = 4;      ///< Dimension of the cube.
   static constexpr int NSQUARES = 6;      ///< Number of squares in the cube.
+
+ public:
+  /**
+   * @brief Lines of the cube for one pattern of corners above the value.
+   *
+   * The corner [ci][cj][ck] is bit 4 * ci + 2 * cj + ck of the pattern. The
+   * edge along the local direction d (0, 1 or 2 for ci, cj, ck) with the
+   * lower corner c has the index 4 * d plus the bits of c in the other two
+   * directions.
+   */
+  struct CubeCase {
+    int number_lines;  ///< Number of lines in the cube.
+    bool ambiguous;    ///< The lines have to be connected by hand.
+    std::array<std::array<int, 3>, NSQUARES>
+        lines;  ///< Square and the two cut edges of each line.
+  };
+
+  /**
+   * @brief Gets the index of the edge along a direction from a corner.
+   * @param direction Local direction of the edge (0, 1 or 2).
+   * @param corner Index of the lower corner of the edge.
+   * @return The index of the edge.
+   */
+  static constexpr int edge_index(int direction, int corner) {
+    int index = 0;
+    for (int d = 0; d < 3; d++) {
+      if (d != direction) {
+        index = 2 * index + ((corner >> (2 - d)) & 1);
+      }
+    }
+    return 4 * direction + index;
+  }
+
+  /**
+   * @brief Gets the lower corner of an edge.
+   * @param edge Index of the edge.
+   * @return The index of the lower corner of the edge.
+   */
+  static constexpr int edge_corner(int edge) {
+    const int direction = edge / 4;
+    int low = 0;
+    int bit = 1;
+    for (int d = 2; d >= 0; d--) {
+      if (d != direction) {
+        low |= ((edge & bit) ? 1 : 0) << (2 - d);
+        bit <<= 1;
+      }
+    }
+    return low;
+  }
+
+  /**
+   * @brief Gets the index of an edge of one of the squares of the cube.
+   * @param square Index of the square in the order of split_to_squares().
+   * @param local_edge Index of the edge in the square in the order of
+   * Square::ends_of_edge().
+   * @return The index of the edge in the cube.
+   */
+  static constexpr int square_edge_index(int square, int local_edge) {
+    const int fixed = square / 2;
+    const int a = (fixed == 0) ? 1 : 0;
+    const int b = (fixed == 2) ? 1 : 2;
+    const int base = (square % 2) << (2 - fixed);
+    switch (local_edge) {
+      case 0:
+        return edge_index(a, base);
+      case 1:
+        return edge_index(b, base);
+      case 2:
+        return edge_index(b, base | (1 << (2 - a)));
+      default:
+        return edge_index(a, base | (1 << (2 - b)));
+    }
+  }
+
+ private:
   static constexpr int STEPS = 2;         ///< Number of steps.
   static constexpr int MAX_POLYGONS = 8;  ///< Maximum number of polygons.
+  static constexpr int NCORNERS = 8;      ///< Number of corners of the cube.
+  static constexpr int NEDGES = 12;       ///< Number of edges of the cube.
+  static constexpr int NCASES = 256;      ///< Number of corner patterns.
+
+  static const std::array<CubeCase, NCASES>
+      cases;  ///< Lines for all corner patterns.
+  static const std::array<std::array<int, 2>, NEDGES>
+      edge_corners;  ///< Lower and upper corner of each edge.
+
+  /**
+   * @brief Builds the table of lines for all corner patterns.
+   *
+   * The squares are taken in the order of split_to_squares() and the cuts
+   * of a square in the order of Square::ends_of_edge().
+   *
+   * @return The table of lines.
+   */
+  static constexpr std::array<CubeCase, NCASES> build_cases() {
+    std::array<CubeCase, NCASES> table = {};
+    for (int pattern = 0; pattern < NCASES; pattern++) {
+      CubeCase& cube_case = table[pattern];
+      for (int square = 0; square < NSQUARES; square++) {
+        int number_cuts = 0;
+        std::array<int, 4> cuts = {};
+        for (int local_edge = 0; local_edge < 4; local_edge++) {
+          const int edge = square_edge_index(square, local_edge);
+          const int low = edge_corner(edge);
+          const int high = low | (1 << (2 - edge / 4));
+          if (((pattern >> low) & 1) != ((pattern >> high) & 1)) {
+            cuts[number_cuts++] = edge;
+          }
+        }
+        if (number_cuts == 4) {
+          cube_case.ambiguous = true;
+        } else if (number_cuts == 2) {
+          cube_case.lines[cube_case.number_lines++] = {square, cuts[0],
+                                                       cuts[1]};
+        }
+      }
+      if (cube_case.number_lines == 6) {
+        cube_case.ambiguous = true;
+      }
+    }
+    return table;
+  }
+
+  /**
+   * @brief Builds the table of the corners of the edges.
+   * @return The lower and upper corner of each edge.
+   */
+  static constexpr std::array<std::array<int, 2>, NEDGES>
+  build_edge_corners() {
+    std::array<std::array<int, 2>, NEDGES> corners = {};
+    for (int edge = 0; edge < NEDGES; edge++) {
+      const int low = edge_corner(edge);
+      corners[edge] = {low, low | (1 << (2 - edge / 4))};
+    }
+    return corners;
+  }
 
   std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>
       cube;                       ///< 3D array representing the cube.
-  std::vector<Polygon> polygons;  ///< Vector to store the polygons in the cube.
+  FixedVector<Polygon, MAX_POLYGONS>
+      polygons;  ///< Polygons in the cube.
   std::array<Square, NSQUARES> squares;  ///< Array of squares in the cube.
-  std::array<Line, NSQUARES * 2> lines;  ///< Array of lines in the squares.
+  std::array<Square*, NSQUARES>
+      square_refs;  ///< Squares used by the last split into squares.
+  const std::array<Square*, NSQUARES>*
+      given_squares;  ///< Squares constructed by the caller, if any.
+  std::array<Line, NSQUARES * 2>
+      lines;  ///< Lines from the table or copied from shared squares.
+  std::array<Line*, NSQUARES * 2>
+      line_refs;  ///< Lines of the squares used by the last split.
+  std::array<std::array<int, 2>, NSQUARES * 2>
+      line_edges;  ///< Edges of the start and end point of each line.
 
   int number_lines;            ///< Number of lines in the cube.
-  int number_polygons;         ///< Number of polygons in the cube.
   bool ambiguous;              ///< Indicates if the cube is ambiguous.
   int const_i;                 ///< Index for the constant dimension.
   double const_value;          ///< Value for the constant dimension.
@@ -50,6 +206,45 @@ class Cube : public GeneralGeometryElement {
   std::array<std::array<double, STEPS>, STEPS>
       square;  ///< 2D array representing a square
 
+  std::array<std::array<double, DIM>, NEDGES>
+      edge_points;  ///< Cut points on the edges of the cube.
+  const double* given_cuts;  ///< Cuts computed by the caller, if any.
+  std::array<double, NEDGES> cut_values;  ///< Cuts computed by the cube.
+  const double* edge_cuts;  ///< Cuts used for the current value.
+  std::array<std::array<double, 4>, NSQUARES>
+      square_cuts;  ///< Cuts of the edges of each square.
+
+  /**
+   * @brief Finds the cuts of all edges in one pass, unless they are given.
+   * @param value The value of the surface.
+   */
+  void find_edge_cuts(double value);
+
+  /**
+   * @brief Sets the cut point on one edge of the cube from the cuts found by
+   * find_edge_cuts().
+   * @param edge Index of the edge.
+   * @return False if the edge is not cut, which can only happen in
+   * degenerate cases.
+   */
+  bool cut_edge(int edge);
+
+  /**
+   * @brief Constructs the polygon of a cube which is not ambiguous from the
+   * table of lines.
+   * @param cube_case Lines of the corner pattern of the cube.
+   * @param value The value used to construct polygons.
+   * @return False if the table could not be used.
+   */
+  bool construct_polygon_from_case(const CubeCase& cube_case, double value);
+
+  /**
+   * @brief Constructs the polygons by splitting the cube into squares and
+   * connecting the lines of the squares.
+   * @param value The value used to construct polygons.
+   */
+  void construct_polygons_from_squares(double value);
+
  public:
   /**
    * @brief Default constructor for the Cube class.
@@ -61,6 +256,16 @@ class Cube : public GeneralGeometryElement {
    */
   ~Cube();
 
+  /**
+   * @brief Copying and moving are not supported. The polygons, lines and
+   * edge cuts of the cube refer to arrays of the cube itself, so a copy
+   * would keep referring to the arrays of the original.
+   */
+  Cube(const Cube&) = delete;
+  Cube& operator=(const Cube&) = delete;
+  Cube(Cube&&) = delete;
+  Cube& operator=(Cube&&) = delete;
+
   /**
    * @brief Initializes the cube with given parameters.
    * @param cu 3D array representing the cube.
@@ -72,6 +277,37 @@ class Cube : public GeneralGeometryElement {
       std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>& cu,
       int new_const_i, double new_const_value, std::array<double, DIM>& new_dx);
 
+  /**
+   * @brief Sets the cut points on the edges, so that they are not computed
+   * again.
+   *
+   * The cuts are used by the next calls of construct_polygons() until they
+   * are reset with a null pointer. Ambiguous cubes hand them on to their
+   * squares.
+   *
+   * @param cuts Position of the cut on each of the 12 edges relative to its
+   * lower corner as given by Square::edge_cut(), numbered as in CubeCase.
+   */
+  inline void set_edge_cuts(const double* cuts) { given_cuts = cuts; }
+
+  /**
+   * @brief Sets the squares of the cube with their lines already
+   * constructed, so that they are not constructed again.
+   *
+   * In a hypercube every square belongs to two cubes. The squares are used
+   * by the next calls of construct_polygons() which split the cube into
+   * squares, until they are reset with a null pointer. The lines are taken
+   * over with the constant indices of this cube, so the results are the same
+   * as with the squares of the cube.
+   *
+   * @param new_squares Squares in the order of split_to_squares(), with the
+   * same values, dx and constant values. Their constant indices may be in
+   * any order.
+   */
+  inline void set_squares(const std::array<Square*, NSQUARES>* new_squares) {
+    given_squares = new_squares;
+  }
+
   /**
    * @brief Constructs polygons within the cube based on a given value.
    * @param value The value used to construct polygons.
@@ -90,7 +326,7 @@ class Cube : public GeneralGeometryElement {
   inline void check_ambiguity(int number_lines) {
     // Check if any squares may have ambiguous elements
     for (int i = 0; i < NSQUARES; i++) {
-      if (squares[i].is_ambiguous()) {
+      if (square_refs[i]->is_ambiguous()) {
         ambiguous = true;
         return;
       }
@@ -113,7 +349,7 @@ class Cube : public GeneralGeometryElement {
    * @brief Gets the number of polygons in the cube.
    * @return The number of polygons.
    */
-  inline int get_number_polygons() { return number_polygons; }
+  inline int get_number_polygons() { return polygons.size(); }
 
   /**
    * @brief Gets the number of lines in the cube.
@@ -121,11 +357,28 @@ class Cube : public GeneralGeometryElement {
    */
   inline int get_number_lines() { return number_lines; }
 
+  /**
+   * @brief Gets the lines of a pattern of corners above the value.
+   * @param pattern The pattern of corners, see CubeCase.
+   * @return The lines of the pattern.
+   */
+  static inline const CubeCase& get_case(int pattern) {
+    return cases[pattern];
+  }
+
   /**
    * @brief Gets the polygons in the cube.
-   * @return A reference to the array of polygons.
+   * @return A reference to the polygons.
    */
-  inline std::vector<Polygon>& get_polygons() { return polygons; }
+  inline FixedVector<Polygon, MAX_POLYGONS>& get_polygons() {
+    return polygons;
+  }
 };
 
+static_assert(!std::is_copy_constructible<Cube>::value &&
+                  !std::is_copy_assignable<Cube>::value &&
+                  !std::is_move_constructible<Cube>::value &&
+                  !std::is_move_assignable<Cube>::value,
+              "Cube must not be copied or moved.");
+
 #endif  // CUBE_H
\ No newline at end of file
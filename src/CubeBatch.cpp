@@ -0,0 +1,197 @@
+#include "CubeBatch.h"
+
+CubeBatch::CubeBatch() { dx.fill(1.0); }
+
+CubeBatch::~CubeBatch() = default;
+
+void CubeBatch::init_batch(const std::array<double, DIM>& new_dx) {
+  // The padded form of Cornelius, the first direction is not used
+  dx[0] = 1;
+  for (int i = 1; i < DIM; i++) {
+    dx[i] = new_dx[i - 1];
+  }
+  clear();
+}
+
+void CubeBatch::clear() {
+  for (auto& cells : queued) {
+    cells.clear();
+  }
+  cell_cuts.clear();
+  for (int k = 0; k < CUBE_DIM; k++) {
+    normals[k].clear();
+    centroids[k].clear();
+  }
+}
+
+int CubeBatch::add_cell(int pattern, const std::array<double, NEDGES>& cuts) {
+  const Cube::CubeCase& cube_case = Cube::get_case(pattern);
+  if (cube_case.ambiguous || cube_case.number_lines == 0) {
+    return -1;
+  }
+  // Cube falls back to the squares if one of the cuts is missing
+  for (int l = 0; l < cube_case.number_lines; l++) {
+    for (int e = 1; e < 3; e++) {
+      if (std::isnan(cuts[cube_case.lines[l][e]])) {
+        return -1;
+      }
+    }
+  }
+  const int cell = get_number_cells();
+  cell_cuts.push_back(cuts);
+  queued[pattern].push_back(cell);
+  return cell;
+}
+
+void CubeBatch::find_elements() {
+  for (int k = 0; k < CUBE_DIM; k++) {
+    normals[k].resize(cell_cuts.size());
+    centroids[k].resize(cell_cuts.size());
+  }
+  for (int pattern = 0; pattern < NCASES; pattern++) {
+    const std::vector<int>& cells = queued[pattern];
+    const int number_cells = static_cast<int>(cells.size());
+    for (int first = 0; first < number_cells; first += LANES) {
+      find_lanes(pattern, cells.data() + first,
+                 std::min(LANES, number_cells - first));
+    }
+  }
+}
+
+void CubeBatch::find_lanes(int pattern, const int* cells, int number_cells) {
+  const Cube::CubeCase& cube_case = Cube::get_case(pattern);
+  const int number_lines = cube_case.number_lines;
+
+  // Cuts of the cells, the lanes without a cell repeat the last one
+  std::array<Lanes, NEDGES> cuts;
+  for (int i = 0; i < LANES; i++) {
+    const auto& cuts_cell = cell_cuts[cells[std::min(i, number_cells - 1)]];
+    for (int edge = 0; edge < NEDGES; edge++) {
+      cuts[edge][i] = cuts_cell[edge];
+    }
+  }
+
+  // End points of the lines as in Cube::cut_edge(), and the points outside
+  // of the lines as in Cube::construct_polygon_from_case(), which are the
+  // same for all cells
+  std::array<std::array<LaneVector, STEPS>, MAX_LINES> points;
+  std::array<std::array<double, CUBE_DIM>, MAX_LINES> out;
+  for (int l = 0; l < number_lines; l++) {
+    const auto& line = cube_case.lines[l];
+    for (int e = 1; e < 3; e++) {
+      const int edge = line[e];
+      const int direction = edge / 4;
+      const int low = Cube::edge_corner(edge);
+      for (int k = 0; k < CUBE_DIM; k++) {
+        if (k == direction) {
+          points[l][e - 1][k] = cuts[edge];
+        } else {
+          points[l][e - 1][k].fill(((low >> (2 - k)) & 1) ? dx[k + 1] : 0);
+        }
+      }
+    }
+    const int fixed = line[0] / 2;
+    const int j = line[0] % 2;
+    const int a = (fixed == 0) ? 1 : 0;
+    const int b = (fixed == 2) ? 1 : 2;
+    double out_a = 0.0;
+    double out_b = 0.0;
+    int number_out = 0;
+    for (int ci1 = 0; ci1 < STEPS; ci1++) {
+      for (int ci2 = 0; ci2 < STEPS; ci2++) {
+        const int c = (j << (2 - fixed)) | (ci1 << (2 - a)) | (ci2 << (2 - b));
+        if (!((pattern >> c) & 1)) {
+          out_a += ci1 * dx[a + 1];
+          out_b += ci2 * dx[b + 1];
+          number_out++;
+        }
+      }
+    }
+    out[l][a] = out_a / number_out;
+    out[l][b] = out_b / number_out;
+    out[l][fixed] = j * dx[fixed + 1];
+  }
+
+  // Mean of the corner points as in Polygon::calculate_centroid()
+  LaneVector mean = {};
+  for (int l = 0; l < number_lines; l++) {
+    for (int k = 0; k < CUBE_DIM; k++) {
+      for (int i = 0; i < LANES; i++) {
+        mean[k][i] += points[l][0][k][i] + points[l][1][k][i];
+      }
+    }
+  }
+  for (int k = 0; k < CUBE_DIM; k++) {
+    for (int i = 0; i < LANES; i++) {
+      mean[k][i] /= (2.0 * number_lines);
+    }
+  }
+
+  // One pass over the triangles formed from the lines and the mean point
+  // gives the area weighted centroid and the normal
+  LaneVector sum_up = {};
+  Lanes sum_down = {};
+  LaneVector normal = {};
+  for (int l = 0; l < number_lines; l++) {
+    const LaneVector& start = points[l][0];
+    const LaneVector& end = points[l][1];
+    for (int i = 0; i < LANES; i++) {
+      const double a0 = start[0][i] - mean[0][i];
+      const double a1 = start[1][i] - mean[1][i];
+      const double a2 = start[2][i] - mean[2][i];
+      const double b0 = end[0][i] - mean[0][i];
+      const double b1 = end[1][i] - mean[1][i];
+      const double b2 = end[2][i] - mean[2][i];
+      const double cross1 = a1 * b2 - a2 * b1;
+      const double cross2 = a0 * b2 - a2 * b0;
+      const double cross3 = a1 * b0 - a0 * b1;
+      const double area =
+          0.5 * std::sqrt(cross1 * cross1 + cross2 * cross2 + cross3 * cross3);
+      for (int k = 0; k < CUBE_DIM; k++) {
+        sum_up[k][i] += area * ((start[k][i] + end[k][i] + mean[k][i]) / 3.0);
+      }
+      sum_down[i] += area;
+      // The normal of the triangle points away from the outside point
+      double n0 = 0.5 * cross1;
+      double n1 = -0.5 * cross2;
+      double n2 = -0.5 * cross3;
+      const double dot = n0 * (out[l][0] - mean[0][i]) +
+                         n1 * (out[l][1] - mean[1][i]) +
+                         n2 * (out[l][2] - mean[2][i]);
+      n0 = (dot < 0) ? -n0 : n0;
+      n1 = (dot < 0) ? -n1 : n1;
+      n2 = (dot < 0) ? -n2 : n2;
+      normal[0][i] += n0;
+      normal[1][i] += n1;
+      normal[2][i] += n2;
+    }
+  }
+
+  // With 3 lines the polygon is a triangle and its centroid is the mean
+  for (int i = 0; i < number_cells; i++) {
+    for (int k = 0; k < CUBE_DIM; k++) {
+      normals[k][cells[i]] = normal[k][i];
+      centroids[k][cells[i]] = (number_lines == 3)
+                                   ? mean[k][i]
+                                   : sum_up[k][i] / sum_down[i];
+    }
+  }
+}
+
+double CubeBatch::get_normal_element(int cell, int component) const {
+  if (cell < 0 || cell >= static_cast<int>(normals[0].size()) ||
+      component < 0 || component >= CUBE_DIM) {
+    throw std::out_of_range(
+        "CubeBatch error: asking for an element which does not exist.");
+  }
+  return normals[component][cell];
+}
+
+double CubeBatch::get_centroid_element(int cell, int component) const {
+  if (cell < 0 || cell >= static_cast<int>(centroids[0].size()) ||
+      component < 0 || component >= CUBE_DIM) {
+    throw std::out_of_range(
+        "CubeBatch error: asking for an element which does not exist.");
+  }
+  return centroids[component][cell];
+}
@@ -0,0 +1,134 @@
+#ifndef CUBE_BATCH_H
+#define CUBE_BATCH_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "Cube.h"
+
+/**
+ * @class CubeBatch
+ * @brief Finds the surface elements of many 3D cells together.
+ *
+ * A cell which is not ambiguous has exactly one surface element. The corner
+ * pattern of the cell fixes which edges are cut, how the cuts are joined into
+ * lines and the points outside of the lines, so only the positions of the
+ * cuts differ between cells with the same pattern. The cells are therefore
+ * queued by their pattern, and the cells of one pattern are handled LANES at
+ * a time: the coordinates of the lines, the centroid and the normal are kept
+ * with one array entry per cell, and every step is done for all cells at
+ * once in a loop which the compiler vectorizes. The steps are the ones of
+ * Cube, Line and Polygon in the same order, so the elements are the same bit
+ * by bit as the ones found by Cornelius for each cell on its own.
+ *
+ * Cells which are ambiguous, or whose cuts do not match their pattern, are
+ * not taken and have to be handled by Cornelius.
+ *
+ */
+class CubeBatch {
+ private:
+  static constexpr int DIM = 4;        ///< Dimension of the space.
+  static constexpr int CUBE_DIM = 3;   ///< Dimension of the cells.
+  static constexpr int STEPS = 2;      ///< Number of steps.
+  static constexpr int NEDGES = 12;    ///< Number of edges of a cell.
+  static constexpr int NCASES = 256;   ///< Number of corner patterns.
+  static constexpr int MAX_LINES = 5;  ///< Lines of a cell which is taken.
+  static constexpr int LANES = 8;      ///< Cells handled together.
+
+  using Lanes = std::array<double, LANES>;  ///< One value of each cell.
+  using LaneVector =
+      std::array<Lanes, CUBE_DIM>;  ///< One vector of each cell.
+
+  std::array<double, DIM> dx;  ///< Lengths of the edges in padded form.
+  std::array<std::vector<int>, NCASES>
+      queued;  ///< Cells waiting to be handled, by pattern.
+  std::vector<std::array<double, NEDGES>> cell_cuts;  ///< Cuts of each cell.
+  std::array<std::vector<double>, CUBE_DIM>
+      normals;  ///< Components of the normals of the cells.
+  std::array<std::vector<double>, CUBE_DIM>
+      centroids;  ///< Components of the centroids of the cells.
+
+  /**
+   * @brief Finds the elements of up to LANES cells with the same pattern.
+   *
+   * @param pattern The corner pattern of the cells.
+   * @param cells Indices of the cells.
+   * @param number_cells Number of cells, [1,LANES].
+   */
+  void find_lanes(int pattern, const int* cells, int number_cells);
+
+ public:
+  /**
+   * @brief Default constructor for the CubeBatch class.
+   */
+  CubeBatch();
+
+  /**
+   * @brief Destructor for the CubeBatch class.
+   */
+  ~CubeBatch();
+
+  /**
+   * @brief Sets the size of the cells and discards all cells.
+   *
+   * @param new_dx Lengths of the edges of the cells in the three directions,
+   * as given to Cornelius::init_cornelius().
+   */
+  void init_batch(const std::array<double, DIM>& new_dx);
+
+  /**
+   * @brief Discards all cells. The memory is kept.
+   */
+  void clear();
+
+  /**
+   * @brief Adds a cell, unless it has to be handled by Cornelius.
+   *
+   * @param pattern The corner pattern of the cell as in Cube::CubeCase, i.e.
+   * bit 4 * ci + 2 * cj + ck is set if the corner [ci][cj][ck] is at or
+   * above the value.
+   * @param cuts Position of the cut on each edge relative to its lower corner
+   * as given by Square::edge_cut(), numbered as in Cube::CubeCase.
+   * @return The index of the cell in the batch, or -1 if the cell is not
+   * taken.
+   */
+  int add_cell(int pattern, const std::array<double, NEDGES>& cuts);
+
+  /**
+   * @brief Finds the elements of all cells which were added.
+   */
+  void find_elements();
+
+  /**
+   * @brief Gets the number of cells which were added.
+   *
+   * @return The number of cells.
+   */
+  inline int get_number_cells() const {
+    return static_cast<int>(cell_cuts.size());
+  }
+
+  /**
+   * @brief Gets a component of the normal of the element of a cell.
+   *
+   * @param cell The index of the cell as returned by add_cell().
+   * @param component The index of the component, [0,3).
+   * @return The component of the normal.
+   */
+  double get_normal_element(int cell, int component) const;
+
+  /**
+   * @brief Gets a component of the centroid of the element of a cell,
+   * relative to the lower corner of the cell.
+   *
+   * @param cell The index of the cell as returned by add_cell().
+   * @param component The index of the component, [0,3).
+   * @return The component of the centroid.
+   */
+  double get_centroid_element(int cell, int component) const;
+};
+
+#endif  // CUBE_BATCH_H
@@ -0,0 +1,124 @@
+#ifndef FIXED_VECTOR_H
+#define FIXED_VECTOR_H
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+
+/**
+ * @class FixedVector
+ * @brief Vector with a capacity fixed at compile time and its elements
+ * stored inline.
+ *
+ * The geometry classes know the largest number of lines, polygons and
+ * polyhedra they can hold, so they keep them in a FixedVector instead of a
+ * std::vector. It never allocates. The container itself makes no promise
+ * about copying: it copies like a std::array of its elements, and the
+ * geometry classes which refer to their own elements cannot be copied.
+ *
+ * All elements are constructed with the container. clear() only resets the
+ * size, and push_slot() hands out the next element as it was left by its
+ * last use, so elements which keep their own memory can be reused from cell
+ * to cell. Unlike std::vector::emplace_back(), no element is constructed,
+ * and the caller has to initialize the element it gets. Adding more
+ * elements than the capacity is an error and exits.
+ *
+ * @tparam T Type of the elements.
+ * @tparam N Capacity of the container.
+ */
+template <typename T, int N>
+class FixedVector {
+ private:
+  std::array<T, N> elements;  ///< Storage of all elements.
+  int number_elements;        ///< Number of elements in use.
+
+  /**
+   * @brief Exits if there is no space for one more element.
+   */
+  inline void check_capacity() const {
+    if (number_elements >= N) {
+      std::cerr << "FixedVector error: capacity of " << N << " exceeded."
+                << std::endl;
+      exit(1);
+    }
+  }
+
+ public:
+  /**
+   * @brief Default constructor for the FixedVector class. The container is
+   * empty.
+   */
+  FixedVector() : number_elements(0) {}
+
+  /**
+   * @brief Gets the capacity of the container.
+   * @return The capacity.
+   */
+  static constexpr int capacity() { return N; }
+
+  /**
+   * @brief Gets the number of elements in use.
+   * @return The number of elements.
+   */
+  inline int size() const { return number_elements; }
+
+  /**
+   * @brief Checks if the container is empty.
+   * @return True if there are no elements in use.
+   */
+  inline bool empty() const { return number_elements == 0; }
+
+  /**
+   * @brief Discards all elements. The elements themselves are kept.
+   */
+  inline void clear() { number_elements = 0; }
+
+  /**
+   * @brief Adds a copy of an element at the end.
+   * @param value The element to add.
+   */
+  inline void push_back(const T& value) {
+    check_capacity();
+    elements[number_elements++] = value;
+  }
+
+  /**
+   * @brief Takes the next element into use without resetting it.
+   *
+   * The element holds whatever its last use left in it, so the caller has
+   * to initialize it.
+   *
+   * @return A reference to the element.
+   */
+  inline T& push_slot() {
+    check_capacity();
+    return elements[number_elements++];
+  }
+
+  /**
+   * @brief Gets an element.
+   * @param index The index of the element, [0,size()).
+   * @return A reference to the element.
+   */
+  inline T& operator[](int index) { return elements[index]; }
+
+  /**
+   * @brief Gets an element.
+   * @param index The index of the element, [0,size()).
+   * @return A constant reference to the element.
+   */
+  inline const T& operator[](int index) const { return elements[index]; }
+
+  /**
+   * @brief Gets the last element in use.
+   * @return A reference to the element.
+   */
+  inline T& back() { return elements[number_elements - 1]; }
+
+  inline T* begin() { return elements.data(); }
+  inline T* end() { return elements.data() + number_elements; }
+  inline const T* begin() const { return elements.data(); }
+  inline const T* end() const { return elements.data() + number_elements; }
+};
+
+#endif  // FIXED_VECTOR_H
@@ -1,8 +1,17 @@
 #include "Hypercube.h"
 
-Hypercube::Hypercube() : number_polyhedra(0), ambiguous(false) {
-  polyhedra.reserve(MAX_POLYHEDRONS);
-  polyhedra.emplace_back();  // Default to construct 1 Polyhedron
+const std::array<Hypercube::CubeMap, Hypercube::NCUBES> Hypercube::cube_maps =
+    Hypercube::build_cube_maps();
+
+const std::array<std::array<int, 2>, Hypercube::NEDGES>
+    Hypercube::edge_corners = Hypercube::build_edge_corners();
+
+Hypercube::Hypercube()
+    : ambiguous(false),
+      given_cuts(nullptr),
+      edge_cuts(nullptr) {
+  lower_face_centroids.fill(nullptr);
+  upper_faces.fill(-1);
 }
 
 Hypercube::~Hypercube() = default;
@@ -13,8 +22,9 @@ void Hypercube::init_hypercube(
     std::array<double, DIM>& new_dx) {
   hypercube = hc;
   dx = new_dx;
-  number_polyhedra = 0;
+  polyhedra.clear();
   ambiguous = false;
+  upper_faces.fill(-1);
 }
 
 int Hypercube::split_to_cubes(double value) {
@@ -59,55 +69,242 @@ int Hypercube::split_to_cubes(double value) {
 }
 
 void Hypercube::construct_polyhedra(double value) {
+  int pattern = 0;
+  for (int h = 0; h < NCORNERS; h++) {
+    values[h] = hypercube[h >> 3][(h >> 2) & 1][(h >> 1) & 1][h & 1];
+    if (values[h] >= value) {
+      pattern |= 1 << h;
+    }
+  }
+  // Cut all edges at once, the polyhedra are then built from the cuts
+  find_edge_cuts(value);
+  // The hypercube is ambiguous if one of the cubes is, or if there are 24
+  // lines and only two corners on one side of the surface
+  std::array<int, NCUBES> cube_patterns;
+  bool may_be_ambiguous = false;
+  int number_lines = 0;
+  for (int i = 0; i < NCUBES; i++) {
+    cube_patterns[i] = cube_maps[i].patterns[0][pattern & 0xff] |
+                       cube_maps[i].patterns[1][pattern >> 8];
+    const Cube::CubeCase& cube_case = Cube::get_case(cube_patterns[i]);
+    may_be_ambiguous = may_be_ambiguous || cube_case.ambiguous;
+    number_lines += cube_case.number_lines;
+  }
+  int number_points_below_value = NCORNERS;
+  for (int h = 0; h < NCORNERS; h++) {
+    number_points_below_value -= (pattern >> h) & 1;
+  }
+  number_points_below_value =
+      std::min(number_points_below_value, 16 - number_points_below_value);
+  if (number_lines == 24 && number_points_below_value == 2) {
+    may_be_ambiguous = true;
+  }
+  if (!may_be_ambiguous &&
+      construct_polyhedron_from_cases(cube_patterns, value)) {
+    return;
+  }
+  polyhedra.clear();
+  upper_faces.fill(-1);
+  construct_polyhedra_from_cubes(cube_patterns, value);
+}
+
+void Hypercube::find_edge_cuts(double value) {
+  if (given_cuts != nullptr) {
+    edge_cuts = given_cuts;
+    return;
+  }
+  // Gather the corners of the edges, so that all edges are cut in one loop
+  std::array<double, NEDGES> values_low;
+  std::array<double, NEDGES> values_high;
+  std::array<double, NEDGES> delta_x;
+  for (int edge = 0; edge < NEDGES; edge++) {
+    values_low[edge] = values[edge_corners[edge][0]];
+    values_high[edge] = values[edge_corners[edge][1]];
+    delta_x[edge] = dx[edge / 8];
+  }
+  Square::edge_cuts(NEDGES, values_low.data(), values_high.data(), value,
+                    delta_x.data(), cut_values.data());
+  edge_cuts = cut_values.data();
+}
+
+bool Hypercube::cut_edge(int edge) {
+  const int direction = edge / 8;
+  const double cut = edge_cuts[edge];
+  if (std::isnan(cut)) {
+    return false;
+  }
+  const int low = edge_corners[edge][0];
+  auto& point = edge_points[edge];
+  for (int d = 0; d < DIM; d++) {
+    point[d] = (d == direction)            ? cut
+               : ((low >> (3 - d)) & 1) ? dx[d]
+                                          : 0;
+  }
+  return true;
+}
+
+bool Hypercube::construct_polyhedron_from_cases(
+    const std::array<int, NCUBES>& cube_patterns, double value) {
+  unsigned int edges_done = 0;
+  std::array<std::array<double, DIM>, STEPS> points_line;
+  std::array<double, DIM> out_line;
+  int number_polygons = 0;
+  int number_lines = 0;
+  for (int i = 0; i < NCUBES; i++) {
+    const Cube::CubeCase& cube_case = Cube::get_case(cube_patterns[i]);
+    if (cube_case.number_lines == 0) {
+      continue;
+    }
+    const CubeMap& map = cube_maps[i];
+    const int const_i = i / 2;
+    const double const_value = (i % 2) * dx[const_i];
+    if (i % 2 == 1) {
+      upper_faces[const_i] = number_polygons;
+    }
+    Polygon& polygon = polygons[number_polygons++];
+    polygon.init_polygon(const_i);
+    for (int l = 0; l < cube_case.number_lines; l++) {
+      const auto& cube_line = cube_case.lines[l];
+      for (int e = 1; e < 3; e++) {
+        const int edge = map.edges[cube_line[e]];
+        if (!(edges_done & (1u << edge))) {
+          if (!cut_edge(edge)) {
+            return false;
+          }
+          edges_done |= 1u << edge;
+        }
+        points_line[e - 1] = edge_points[edge];
+      }
+      // The point outside of the line is the mean of the corners of the
+      // square below the value, as in Square::find_outside()
+      const int fixed = cube_line[0] / 2;
+      const int j = cube_line[0] % 2;
+      const int a = (fixed == 0) ? 1 : 0;
+      const int b = (fixed == 2) ? 1 : 2;
+      double out_a = 0.0;
+      double out_b = 0.0;
+      int number_out = 0;
+      for (int ci1 = 0; ci1 < STEPS; ci1++) {
+        for (int ci2 = 0; ci2 < STEPS; ci2++) {
+          const int c =
+              (j << (2 - fixed)) | (ci1 << (2 - a)) | (ci2 << (2 - b));
+          if (values[map.corners[c]] < value) {
+            out_a += ci1 * dx[map.x[a]];
+            out_b += ci2 * dx[map.x[b]];
+            number_out++;
+          }
+        }
+      }
+      out_line[map.x[a]] = out_a / number_out;
+      out_line[map.x[b]] = out_b / number_out;
+      out_line[const_i] = const_value;
+      out_line[map.x[fixed]] = j * dx[map.x[fixed]];
+      Line& line = lines[number_lines++];
+      line.init_line(points_line, out_line, {const_i, map.x[fixed]});
+      polygon.add_line(line, true);
+    }
+    if (i % 2 == 0 && lower_face_centroids[const_i] != nullptr) {
+      // The face was the upper face of the previous hypercube, only the
+      // constant coordinate of the centroid changes
+      std::array<double, DIM> centroid = *lower_face_centroids[const_i];
+      centroid[const_i] = const_value;
+      polygon.set_centroid(centroid);
+    }
+  }
+
+  // Here surface cannot be ambiguous and all polygons can be added to
+  // the polyhedron without ordering them
+  Polyhedron& polyhedron = polyhedra.push_slot();
+  polyhedron.init_polyhedron();
+  for (int i = 0; i < number_polygons; i++) {
+    polyhedron.add_polygon(polygons[i], true);
+  }
+  return true;
+}
+
+void Hypercube::construct_square(int index, double value) {
+  static constexpr std::array<std::array<int, 2>, 6> pairs = {
+      {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}}};
+  std::array<int, 2> c_i = pairs[index / 4];
+  std::array<double, 2> c_v = {((index >> 1) & 1) * dx[c_i[0]],
+                               (index & 1) * dx[c_i[1]]};
+  // The two other directions in increasing order
+  std::array<int, 2> x;
+  int number_directions = 0;
+  for (int d = 0; d < DIM; d++) {
+    if (d != c_i[0] && d != c_i[1]) {
+      x[number_directions++] = d;
+    }
+  }
+  const int base =
+      (((index >> 1) & 1) << (3 - c_i[0])) | ((index & 1) << (3 - c_i[1]));
+  std::array<std::array<double, STEPS>, STEPS> square;
+  for (int ci1 = 0; ci1 < STEPS; ci1++) {
+    for (int ci2 = 0; ci2 < STEPS; ci2++) {
+      square[ci1][ci2] =
+          values[base | (ci1 << (3 - x[0])) | (ci2 << (3 - x[1]))];
+    }
+  }
+  // The cuts of the edges of the square, in the order of
+  // Square::ends_of_edge()
+  const int corner_x0 = 1 << (3 - x[0]);
+  const int corner_x1 = 1 << (3 - x[1]);
+  square_cuts[index] = {edge_cuts[edge_index(x[0], base)],
+                        edge_cuts[edge_index(x[1], base)],
+                        edge_cuts[edge_index(x[1], base | corner_x0)],
+                        edge_cuts[edge_index(x[0], base | corner_x1)]};
+  squares[index].init_square(square, c_i, c_v, dx);
+  squares[index].set_edge_cuts(square_cuts[index].data());
+  squares[index].construct_lines(value);
+}
+
+void Hypercube::construct_polyhedra_from_cubes(
+    const std::array<int, NCUBES>& cube_patterns, double value) {
   const int number_points_below_value = split_to_cubes(value);
 
   // Store the reference to the polygons
   int number_polygons = 0;
+  unsigned int squares_done = 0;
   for (int i = 0; i < NCUBES; i++) {
+    const CubeMap& map = cube_maps[i];
+    for (int e = 0; e < 12; e++) {
+      cube_cuts[i][e] = edge_cuts[map.edges[e]];
+    }
+    cubes[i].set_edge_cuts(cube_cuts[i].data());
+    // Ambiguous cubes are split into squares, which are shared with the
+    // neighbouring cubes
+    if (Cube::get_case(cube_patterns[i]).ambiguous) {
+      for (int square = 0; square < 6; square++) {
+        const int index = map.squares[square];
+        if (!(squares_done & (1u << index))) {
+          construct_square(index, value);
+          squares_done |= 1u << index;
+        }
+        cube_squares[i][square] = &squares[index];
+      }
+      cubes[i].set_squares(&cube_squares[i]);
+    }
     cubes[i].construct_polygons(value);
-    const auto& polygons_cube = cubes[i].get_polygons();
+    cubes[i].set_edge_cuts(nullptr);
+    cubes[i].set_squares(nullptr);
+    auto& polygons_cube = cubes[i].get_polygons();
     for (int j = 0; j < cubes[i].get_number_polygons(); j++) {
-      polygons[number_polygons++] = polygons_cube[j];
+      polygon_refs[number_polygons++] = &polygons_cube[j];
     }
   }
-  check_ambiguity(value);
+  check_ambiguity(number_points_below_value);
   if (ambiguous) {
     // The surface might be ambiguous and we need to connect the polygons and
     // see how many polyhedra we have
-    std::array<bool, NCUBES* 10> not_used = {true};
-    // Keep track of the used number of lines
-    int used = 0;
-    do {
-      // Ensure there's space in the vector
-      if (number_polyhedra >= polyhedra.size()) {
-        polyhedra.emplace_back();  // Add a new Polyhedron if needed
-      }
-      polyhedra[number_polyhedra].init_polyhedron();
-      // Go through all the polygons and try to add them to the polyhedron
-      for (int i = 0; i < number_polygons; i++) {
-        // add_polygon returns true if the polygon was added
-        if (not_used[i] &&
-            polyhedra[number_polyhedra].add_polygon(polygons[i], false)) {
-          not_used[i] = false;
-          used++;
-          // If the polygon is successfully added we start the loop from the
-          // beginning
-          i = 0;
-        }
-      }
-      number_polyhedra++;
-    } while (used < number_polygons);
+    connect_polygons(number_polygons);
   } else {
     // Here surface cannot be ambiguous and all polygons can be added to
     // the polyhedron without ordering them
-    if (number_polyhedra >= polyhedra.size()) {
-      polyhedra.emplace_back();  // Add a new Polyhedron if needed
-    }
-    polyhedra[number_polyhedra].init_polyhedron();
+    Polyhedron& polyhedron = polyhedra.push_slot();
+    polyhedron.init_polyhedron();
     for (int i = 0; i < number_polygons; i++) {
-      polyhedra[number_polyhedra].add_polygon(polygons[i], true);
+      polyhedron.add_polygon(*polygon_refs[i], true);
     }
-    number_polyhedra++;
   }
 }
 
@@ -129,3 +326,71 @@ void Hypercube::check_ambiguity(int number_points_below_value) {
     }
   }
 }
+
+std::uint64_t Hypercube::point_hash(const std::array<double, DIM>& point) {
+  std::uint64_t hash = 0;
+  for (double x : point) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    hash = (hash ^ bits) * 0x9e3779b97f4a7c15ULL;
+  }
+  return hash;
+}
+
+void Hypercube::connect_polygons(int number_polygons) {
+  // Hash table of the start points of all lines, with the polygon of each
+  std::array<int, HASH_SIZE> slots;
+  slots.fill(-1);
+  std::array<const std::array<double, DIM>*, NCUBES * MAX_CUBE_LINES> starts;
+  std::array<int, NCUBES * MAX_CUBE_LINES> start_polygons;
+  int number_starts = 0;
+  for (int i = 0; i < number_polygons; i++) {
+    for (int j = 0; j < polygon_refs[i]->get_number_lines(); j++) {
+      const auto& point = polygon_refs[i]->get_line(j).get_start_point();
+      std::uint64_t slot = point_hash(point) >> HASH_SHIFT;
+      while (slots[slot] >= 0) {
+        slot = (slot + 1) % HASH_SIZE;
+      }
+      slots[slot] = number_starts;
+      starts[number_starts] = &point;
+      start_polygons[number_starts++] = i;
+    }
+  }
+  // A polygon can be added to a polyhedron if one of its points is the
+  // start point of a line of a polygon in the polyhedron, as in
+  // Polyhedron::add_polygon()
+  std::array<std::uint64_t, NCUBES * MAX_CUBE_POLYGONS> attached;
+  attached.fill(0);
+  for (int i = 0; i < number_polygons; i++) {
+    for (int j = 0; j < polygon_refs[i]->get_number_lines(); j++) {
+      Line& line = polygon_refs[i]->get_line(j);
+      for (const auto* point :
+           {&line.get_start_point(), &line.get_end_point()}) {
+        for (std::uint64_t slot = point_hash(*point) >> HASH_SHIFT;
+             slots[slot] >= 0; slot = (slot + 1) % HASH_SIZE) {
+          const int start = slots[slot];
+          if (start_polygons[start] != i && *starts[start] == *point) {
+            attached[start_polygons[start]] |= std::uint64_t(1) << i;
+          }
+        }
+      }
+    }
+  }
+  // Each polyhedron starts from the first unused polygon and takes the
+  // attached polygons with the smallest index first, which gives the same
+  // order as adding them one by one with Polyhedron::add_polygon()
+  std::uint64_t unused = (number_polygons == 64)
+                             ? ~std::uint64_t(0)
+                             : (std::uint64_t(1) << number_polygons) - 1;
+  while (unused != 0) {
+    Polyhedron& polyhedron = polyhedra.push_slot();
+    polyhedron.init_polyhedron();
+    std::uint64_t candidates = unused & -unused;
+    while (candidates != 0) {
+      const int i = __builtin_ctzll(candidates);
+      polyhedron.add_polygon(*polygon_refs[i], true);
+      unused &= ~(std::uint64_t(1) << i);
+      candidates = (candidates | attached[i]) & unused;
+    }
+  }
+}
@@ -2,10 +2,14 @@
 #define HYPERCUBE_H
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <numeric>
+#include <type_traits>
 #include <vector>
 
 #include "Cube.h"
+#include "FixedVector.h"
 #include "GeneralGeometryElement.h"
 #include "Polyhedron.h"
 
@@ -18,6 +22,17 @@
  * cubes, check for ambiguities, construct polyhedra, and access geometric
  * elements.
  *
+ * The 16-bit pattern of corners above the value decides if the hypercube can
+ * be ambiguous. If not, the polygons of the eight cubes are built directly
+ * from the line table of Cube, and every edge of the hypercube is cut only
+ * once even though it belongs to three cubes. Ambiguous hypercubes are split
+ * into cubes and the polygons are connected as before.
+ *
+ * The upper face of a hypercube in one direction is the lower face of the
+ * next hypercube in that direction. When the hypercubes of a lattice are
+ * searched in order, the centroid of the polygon on such a face can be
+ * handed over from one hypercube to the next instead of being computed twice.
+ *
  * 13.10.2011 Hannu Holopainen
  * 23.08.2024 Hendrik Roch, Haydar Mehryar
  */
@@ -28,17 +43,164 @@ class Hypercube : public GeneralGeometryElement {
   static constexpr int NCUBES = 8;  ///< Number of cubes in the hypercube.
   static constexpr int MAX_POLYHEDRONS =
       10;  ///< Maximum number of polyhedrons.
+  static constexpr int NCORNERS = 16;  ///< Number of corners.
+  static constexpr int NEDGES = 32;    ///< Number of edges.
+  static constexpr int NSQUARES = 24;  ///< Number of squares.
+  static constexpr int MAX_CUBE_POLYGONS =
+      4;  ///< Maximum number of polygons in a cube.
+  static constexpr int MAX_CUBE_LINES = 12;  ///< Maximum lines in a cube.
+  static constexpr int MAX_CASE_LINES =
+      6;  ///< Maximum lines in a cube taken from the table.
+  static constexpr int HASH_SIZE = 256;  ///< Slots of the point hash table.
+  static constexpr int HASH_SHIFT = 56;  ///< Shift of the hash to a slot.
+
+  /**
+   * @brief Corners and edges of one cube of the hypercube.
+   *
+   * The corner [h0][h1][h2][h3] of the hypercube has the index
+   * 8 * h0 + 4 * h1 + 2 * h2 + h3, and the edge along the direction d with
+   * the lower corner h has the index 8 * d plus the bits of h in the other
+   * three directions. The square with the constant directions d1 < d2 at
+   * the steps j1 and j2 has the index 4 * (index of the pair d1, d2) +
+   * 2 * j1 + j2, where the pairs are numbered in lexicographic order. The
+   * cubes are numbered as in split_to_cubes().
+   */
+  struct CubeMap {
+    std::array<int, 3> x;        ///< Directions of the cube in the hypercube.
+    std::array<int, 8> corners;  ///< Hypercube corner of each cube corner.
+    std::array<int, 12> edges;   ///< Hypercube edge of each cube edge.
+    std::array<int, 6> squares;  ///< Hypercube square of each cube square.
+    std::array<std::array<int, 256>, 2>
+        patterns;  ///< Cube pattern from the low and the high byte.
+  };
+
+  static const std::array<CubeMap, NCUBES>
+      cube_maps;  ///< Corners and edges of all cubes.
+  static const std::array<std::array<int, 2>, NEDGES>
+      edge_corners;  ///< Lower and upper corner of each edge.
+
+  /**
+   * @brief Gets the index of the edge along a direction from a corner.
+   * @param direction Direction of the edge.
+   * @param corner Index of the lower corner of the edge.
+   * @return The index of the edge, 8 * direction plus the bits of the corner
+   * in the other three directions.
+   */
+  static constexpr int edge_index(int direction, int corner) {
+    int index = 0;
+    for (int d = 0; d < DIM; d++) {
+      if (d != direction) {
+        index = 2 * index + ((corner >> (3 - d)) & 1);
+      }
+    }
+    return 8 * direction + index;
+  }
+
+  /**
+   * @brief Builds the table of the corners of the edges.
+   * @return The lower and upper corner of each edge.
+   */
+  static constexpr std::array<std::array<int, 2>, NEDGES>
+  build_edge_corners() {
+    std::array<std::array<int, 2>, NEDGES> corners = {};
+    for (int corner = 0; corner < NCORNERS; corner++) {
+      for (int d = 0; d < DIM; d++) {
+        if (!((corner >> (3 - d)) & 1)) {
+          corners[edge_index(d, corner)] = {corner, corner | (1 << (3 - d))};
+        }
+      }
+    }
+    return corners;
+  }
+
+  /**
+   * @brief Gets the index of a pair of directions d1 < d2 in lexicographic
+   * order.
+   * @param d1 The first direction.
+   * @param d2 The second direction.
+   * @return The index of the pair in [0,6).
+   */
+  static constexpr int pair_index(int d1, int d2) {
+    return (d1 == 0) ? d2 - 1 : (d1 == 1) ? d2 + 1 : 5;
+  }
+
+  /**
+   * @brief Builds the corner and edge maps of the cubes.
+   * @return The maps of all cubes.
+   */
+  static constexpr std::array<CubeMap, NCUBES> build_cube_maps() {
+    std::array<CubeMap, NCUBES> maps = {};
+    for (int cube_index = 0; cube_index < NCUBES; cube_index++) {
+      CubeMap& map = maps[cube_index];
+      const int fixed = cube_index / 2;
+      const int j = cube_index % 2;
+      int number_directions = 0;
+      for (int d = 0; d < DIM; d++) {
+        if (d != fixed) {
+          map.x[number_directions++] = d;
+        }
+      }
+      for (int c = 0; c < 8; c++) {
+        int corner = j << (3 - fixed);
+        for (int k = 0; k < 3; k++) {
+          corner |= ((c >> (2 - k)) & 1) << (3 - map.x[k]);
+        }
+        map.corners[c] = corner;
+      }
+      for (int k = 0; k < 3; k++) {
+        for (int c = 0; c < 8; c++) {
+          if ((c >> (2 - k)) & 1) {
+            continue;
+          }
+          const int low = map.corners[c];
+          int index = 0;
+          for (int d = 0; d < DIM; d++) {
+            if (d != map.x[k]) {
+              index = 2 * index + ((low >> (3 - d)) & 1);
+            }
+          }
+          map.edges[Cube::edge_index(k, c)] = 8 * map.x[k] + index;
+        }
+      }
+      for (int square = 0; square < 6; square++) {
+        const int fixed_square = map.x[square / 2];
+        const int j_square = square % 2;
+        const bool cube_first = fixed < fixed_square;
+        map.squares[square] =
+            4 * pair_index(cube_first ? fixed : fixed_square,
+                           cube_first ? fixed_square : fixed) +
+            2 * (cube_first ? j : j_square) + (cube_first ? j_square : j);
+      }
+      for (int half = 0; half < 2; half++) {
+        for (int byte = 0; byte < 256; byte++) {
+          int pattern = 0;
+          for (int c = 0; c < 8; c++) {
+            const int bit = map.corners[c] - 8 * half;
+            if (bit >= 0 && bit < 8 && ((byte >> bit) & 1)) {
+              pattern |= 1 << c;
+            }
+          }
+          map.patterns[half][byte] = pattern;
+        }
+      }
+    }
+    return maps;
+  }
 
   std::array<std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>,
              STEPS>
       hypercube;                      ///< 4D array representing the hypercube.
-  std::vector<Polyhedron> polyhedra;  ///< Vector to store the polyhedra.
+  FixedVector<Polyhedron, MAX_POLYHEDRONS>
+      polyhedra;  ///< Polyhedra in the hypercube.
   std::array<Cube, NCUBES>
       cubes;  ///< Array to store the cubes in the hypercube.
-  std::array<Polygon, NCUBES * 10>
-      polygons;  ///< Array to store the polygons in the hypercube.
+  std::array<Polygon, NCUBES>
+      polygons;  ///< Polygons constructed from the table, one per cube.
+  std::array<Line, NCUBES * MAX_CASE_LINES>
+      lines;  ///< Lines of the polygons constructed from the table.
+  std::array<Polygon*, NCUBES * MAX_CUBE_POLYGONS>
+      polygon_refs;  ///< Polygons of all cubes, owned by the cubes.
 
-  int number_polyhedra;        ///< Number of polyhedra in the hypercube.
   bool ambiguous;              ///< Indicates if the hypercube is ambiguous.
   std::array<double, DIM> dx;  ///< Delta values for discretization.
 
@@ -46,6 +208,93 @@ class Hypercube : public GeneralGeometryElement {
   std::array<std::array<std::array<double, STEPS>, STEPS>, STEPS>
       cube;  ///< 3D array representing a cube
 
+  std::array<double, NCORNERS> values;  ///< Values at the corners.
+  std::array<std::array<double, DIM>, NEDGES>
+      edge_points;  ///< Cut points on the edges of the hypercube.
+  std::array<Square, NSQUARES>
+      squares;  ///< Squares shared by the cubes of an ambiguous hypercube.
+  std::array<std::array<Square*, 6>, NCUBES>
+      cube_squares;  ///< Squares of each cube.
+  std::array<std::array<double, 12>, NCUBES>
+      cube_cuts;  ///< Edge cuts of each cube.
+  const double* given_cuts;  ///< Cuts computed by the caller, if any.
+  std::array<double, NEDGES> cut_values;  ///< Cuts computed by the hypercube.
+  const double* edge_cuts;  ///< Cuts used for the current value.
+  std::array<std::array<double, 4>, NSQUARES>
+      square_cuts;  ///< Cuts of the edges of each square.
+  std::array<const std::array<double, DIM>*, DIM>
+      lower_face_centroids;  ///< Centroids given for the lower faces.
+  std::array<int, DIM>
+      upper_faces;  ///< Polygons of the upper faces in the polyhedron.
+
+  /**
+   * @brief Finds the cuts of all 32 edges in one pass with
+   * Square::edge_cuts(), unless they are given by the caller.
+   * @param value The value of the surface.
+   */
+  void find_edge_cuts(double value);
+
+  /**
+   * @brief Sets the cut point on one edge of the hypercube from the cuts
+   * found by find_edge_cuts().
+   * @param edge Index of the edge.
+   * @return False if the edge is not cut, which can only happen in
+   * degenerate cases.
+   */
+  bool cut_edge(int edge);
+
+  /**
+   * @brief Constructs one of the squares shared by the cubes.
+   * @param index Index of the square as in CubeMap.
+   * @param value The value used to construct the lines.
+   */
+  void construct_square(int index, double value);
+
+  /**
+   * @brief Constructs the polyhedron of a hypercube which is not ambiguous
+   * from the line tables of the cubes.
+   * @param cube_patterns Corner patterns of the cubes.
+   * @param value The value used to construct the polyhedron.
+   * @return False if the tables could not be used.
+   */
+  bool construct_polyhedron_from_cases(
+      const std::array<int, NCUBES>& cube_patterns, double value);
+
+  /**
+   * @brief Hash of the coordinates of a point.
+   * @param point The point.
+   * @return The hash.
+   */
+  static std::uint64_t point_hash(const std::array<double, DIM>& point);
+
+  /**
+   * @brief Groups the polygons of an ambiguous hypercube into polyhedra.
+   *
+   * The start points of all lines are put into a hash table, so the
+   * polygons which can be attached to each polygon are found in one pass.
+   * The polyhedra are then grown in the same order as by adding the polygons
+   * one by one with Polyhedron::add_polygon(), but the points are compared
+   * exactly. The cut points on the edges are computed once and copied to
+   * all cubes, so shared points are equal.
+   *
+   * @param number_polygons Number of polygons of the cubes.
+   */
+  void connect_polygons(int number_polygons);
+
+  /**
+   * @brief Constructs the polyhedra by splitting the hypercube into cubes
+   * and connecting the polygons of the cubes.
+   *
+   * Each edge is cut only once and handed to the cubes it belongs to. The
+   * cubes which have to be split into squares share the squares, so each of
+   * the 24 squares of the hypercube is constructed at most once.
+   *
+   * @param cube_patterns Corner patterns of the cubes.
+   * @param value The value used to construct the polyhedra.
+   */
+  void construct_polyhedra_from_cubes(
+      const std::array<int, NCUBES>& cube_patterns, double value);
+
  public:
   /**
    * @brief Default constructor for the Hypercube class.
@@ -57,6 +306,16 @@ class Hypercube : public GeneralGeometryElement {
    */
   ~Hypercube();
 
+  /**
+   * @brief Copying and moving are not supported. The polyhedra, polygons,
+   * squares and edge cuts of the hypercube refer to arrays of the hypercube
+   * itself, so a copy would keep referring to the arrays of the original.
+   */
+  Hypercube(const Hypercube&) = delete;
+  Hypercube& operator=(const Hypercube&) = delete;
+  Hypercube(Hypercube&&) = delete;
+  Hypercube& operator=(Hypercube&&) = delete;
+
   /**
    * @brief Initializes the hypercube with given parameters.
    * @param hc 4D array representing the hypercube.
@@ -81,6 +340,51 @@ class Hypercube : public GeneralGeometryElement {
    */
   void check_ambiguity(int number_points_below_value);
 
+  /**
+   * @brief Sets the cut points on the edges, so that they are not computed
+   * again.
+   *
+   * The cuts are used by the next calls of construct_polyhedra() until they
+   * are reset with a null pointer.
+   *
+   * @param cuts Position of the cut on each of the 32 edges relative to its
+   * lower corner as given by Square::edge_cut(), numbered as in CubeMap.
+   */
+  inline void set_edge_cuts(const double* cuts) { given_cuts = cuts; }
+
+  /**
+   * @brief Sets the centroid of the polygon on the lower face in one
+   * direction, so that it is not computed again.
+   *
+   * The centroid is used by the next calls of construct_polyhedra() until it
+   * is reset with a null pointer. It must have been returned by
+   * get_upper_face_centroid() for a hypercube with the same dx whose upper
+   * face in this direction has the same values as the lower face of this
+   * one. Ambiguous hypercubes do not use it.
+   *
+   * @param direction Direction normal to the face.
+   * @param centroid Centroid of the polygon on the face, or a null pointer.
+   */
+  inline void set_lower_face_centroid(int direction,
+                                      const std::array<double, DIM>* centroid) {
+    lower_face_centroids[direction] = centroid;
+  }
+
+  /**
+   * @brief Gets the centroid of the polygon on the upper face in one
+   * direction found by the last call of construct_polyhedra().
+   *
+   * @param direction Direction normal to the face.
+   * @return Pointer to the centroid, or a null pointer if the face is not
+   * cut or the hypercube was split into cubes.
+   */
+  inline const std::array<double, DIM>* get_upper_face_centroid(
+      int direction) {
+    return (upper_faces[direction] < 0)
+               ? nullptr
+               : &polygons[upper_faces[direction]].get_centroid();
+  }
+
   /**
    * @brief Constructs polyhedra within the hypercube based on a given value.
    * @param value The value used to construct polyhedra.
@@ -91,13 +395,15 @@ class Hypercube : public GeneralGeometryElement {
    * @brief Gets the number of polyhedra in the hypercube.
    * @return The number of polyhedra.
    */
-  inline int get_number_polyhedra() { return number_polyhedra; }
+  inline int get_number_polyhedra() { return polyhedra.size(); }
 
   /**
    * @brief Gets the polyhedra in the hypercube.
-   * @return A reference to the array of polyhedra.
+   * @return A reference to the polyhedra.
    */
-  inline std::vector<Polyhedron>& get_polyhedra() { return polyhedra; }
+  inline FixedVector<Polyhedron, MAX_POLYHEDRONS>& get_polyhedra() {
+    return polyhedra;
+  }
 
   /**
    * @brief Checks if the hypercube is ambiguous.
@@ -106,4 +412,10 @@ class Hypercube : public GeneralGeometryElement {
   inline bool is_ambiguous() { return ambiguous; }
 };
 
+static_assert(!std::is_copy_constructible<Hypercube>::value &&
+                  !std::is_copy_assignable<Hypercube>::value &&
+                  !std::is_move_constructible<Hypercube>::value &&
+                  !std::is_move_assignable<Hypercube>::value,
+              "Hypercube must not be copied or moved.");
+
 #endif  // HYPERCUBE_H
@@ -13,23 +13,6 @@ void Line::init_line(
   out = new_out;
   const_i = new_const_i;
 
-  // Set the indices of the start and end points
-  // This allows us to easily flip the start and end points
-  start_point = 0;
-  end_point = 1;
-
-  // Fix the non-zero indices in such a way that x1 is always smaller
-  if (new_const_i[0] == 0) {
-    x1 = (new_const_i[1] == 1) ? 2 : ((new_const_i[1] == 2) ? 1 : 1);
-    x2 = (new_const_i[1] == 1) ? 3 : ((new_const_i[1] == 2) ? 3 : 2);
-  } else if (new_const_i[0] == 1) {
-    x1 = (new_const_i[1] == 2) ? 0 : 0;
-    x2 = (new_const_i[1] == 2) ? 3 : 2;
-  } else {
-    x1 = 0;
-    x2 = 1;
-  }
-
   // Set the flags for normal and centroid calculations to false
   normal_calculated = centroid_calculated = false;
 }
@@ -39,6 +22,19 @@ void Line::calculate_normal() {
   if (!centroid_calculated) {
     calculate_centroid();
   }
+  // Fix the non-zero indices in such a way that x1 is always smaller
+  int x1;
+  int x2;
+  if (const_i[0] == 0) {
+    x1 = (const_i[1] == 1) ? 2 : ((const_i[1] == 2) ? 1 : 1);
+    x2 = (const_i[1] == 1) ? 3 : ((const_i[1] == 2) ? 3 : 2);
+  } else if (const_i[0] == 1) {
+    x1 = (const_i[1] == 2) ? 0 : 0;
+    x2 = (const_i[1] == 2) ? 3 : 2;
+  } else {
+    x1 = 0;
+    x2 = 1;
+  }
   // The normal is given by (-dy, dx)
   normal[x1] = -(corners[1][x2] - corners[0][x2]);
   normal[x2] = corners[1][x1] - corners[0][x1];
@@ -46,6 +42,7 @@ void Line::calculate_normal() {
   normal[const_i[1]] = 0.0;
 
   // Check if the normal is pointing in the correct direction
+  std::array<double, DIM> reference_normal;
   for (int i = 0; i < DIM; i++) {
     reference_normal[i] = out[i] - centroid[i];
   }
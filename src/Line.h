@@ -16,6 +16,9 @@
  * flip its start and end points, and calculate various geometric properties
  * such as the normal and centroid.
  *
+ * The corners are kept in the order of the line, so flipping the line swaps
+ * them and the start and end points are read without an indirection.
+ *
  * 23.08.2024 Hendrik Roch, Haydar Mehryar
  *
  */
@@ -25,14 +28,10 @@ class Line : public GeneralGeometryElement {
       2;  ///< Dimension for line-specific properties
   static constexpr int LINE_CORNERS = 2;  ///< Number of corners for a line
 
-  int x1, x2;       ///< Indices representing the line's dimensions
-  int start_point;  ///< Index of the start point
-  int end_point;    ///< Index of the end point
   std::array<std::array<double, DIM>, LINE_DIM>
-      corners;                               ///< Array of line corners
-  std::array<double, DIM> out;               ///< Output point of the line
-  std::array<int, DIM - LINE_DIM> const_i;   ///< Constant indices for the line
-  std::array<double, DIM> reference_normal;  ///< Reference normal vector
+      corners;                              ///< Start and end point
+  std::array<double, DIM> out;              ///< Output point of the line
+  std::array<int, DIM - LINE_DIM> const_i;  ///< Constant indices for the line
 
  public:
   /**
@@ -68,7 +67,7 @@ class Line : public GeneralGeometryElement {
    * This method swaps the line's start and end points to reverse the direction
    * of the line.
    */
-  inline void flip_start_end() { std::swap(start_point, end_point); }
+  inline void flip_start_end() { std::swap(corners[0], corners[1]); }
 
   /**
    * @brief Calculates the normal vector of the line.
@@ -92,7 +91,7 @@ class Line : public GeneralGeometryElement {
    * @return Reference to the array representing the start point
    */
   inline std::array<double, GeneralGeometryElement::DIM>& get_start_point() {
-    return corners[start_point];
+    return corners[0];
   }
 
   /**
@@ -101,7 +100,7 @@ class Line : public GeneralGeometryElement {
    * @return Reference to the array representing the end point
    */
   inline std::array<double, GeneralGeometryElement::DIM>& get_end_point() {
-    return corners[end_point];
+    return corners[1];
   }
 
   /**
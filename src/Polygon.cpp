@@ -1,9 +1,6 @@
 #include "Polygon.h"
 
-Polygon::Polygon() {
-  lines.reserve(MAX_LINES);
-  lines.emplace_back();  // Default to construct 1 Line
-}
+Polygon::Polygon() = default;
 
 Polygon::~Polygon() = default;
 
@@ -37,25 +34,21 @@ void Polygon::init_polygon(int new_const_i) {
   }
   // Set the flags for normal and centroid calculations to false
   normal_calculated = centroid_calculated = false;
-  // Reset the number of lines in the polygon
-  number_lines = 0;
+  // Remove the lines of the previous polygon
+  lines.clear();
 }
 
 bool Polygon::add_line(Line& new_line, bool perform_no_check) {
   // For the first line, we don't need to check
-  if (number_lines == 0 || perform_no_check) {
-    // Ensure there's space in the vector
-    if (number_lines >= lines.size()) {
-      lines.emplace_back();  // Add a new Line if needed
-    }
-    lines[number_lines++] = new_line;
+  if (lines.empty() || perform_no_check) {
+    lines.push_back(&new_line);
     return true;
   } else {
     // Check if the current line is connected to the last line, since
     // the lines are ordered
     const auto& start_point = new_line.get_start_point();
     const auto& end_point = new_line.get_end_point();
-    const auto& last_end_point = lines[number_lines - 1].get_end_point();
+    const auto& last_end_point = lines.back()->get_end_point();
 
     double difference1 = 0.0;
     double difference2 = 0.0;
@@ -72,11 +65,7 @@ bool Polygon::add_line(Line& new_line, bool perform_no_check) {
       if (difference2 < EPSILON) {
         new_line.flip_start_end();
       }
-      // Ensure there's space in the vector
-      if (number_lines >= lines.size()) {
-        lines.emplace_back();  // Add a new Line if needed
-      }
-      lines[number_lines++] = new_line;
+      lines.push_back(&new_line);
       return true;
     } else {
       // In this case, the line is not connected to the polygon
@@ -86,13 +75,14 @@ bool Polygon::add_line(Line& new_line, bool perform_no_check) {
 }
 
 void Polygon::calculate_centroid() {
+  const int number_lines = lines.size();
   // Array of 0s to store the mean values
   std::array<double, DIM> mean_values = {0};
 
   // Determine the mean values of the corner points, all points appear twice
   for (int i = 0; i < number_lines; i++) {
-    const auto& start_point = lines[i].get_start_point();
-    const auto& end_point = lines[i].get_end_point();
+    const auto& start_point = lines[i]->get_start_point();
+    const auto& end_point = lines[i]->get_end_point();
     for (int k = 0; k < DIM; ++k) {
       mean_values[k] += start_point[k] + end_point[k];
     }
@@ -100,91 +90,104 @@ void Polygon::calculate_centroid() {
   for (int i = 0; i < DIM; i++) {
     mean_values[i] /= (2.0 * number_lines);
   }
-  // In the case there are only 3 lines, the centroid is the mean of the corner
-  // points and the Polygon is on a plane
-  if (number_lines == 3) {
-    centroid = mean_values;
-    centroid_calculated = true;
-    return;
-  }
-
-  // In the case where there are more than 3 lines, we form triangles from the
-  // lines and the mean point
+  // We form triangles from the lines and the mean point. One pass over them
+  // gives the area weighted centroid and also the normal, since the sum of
+  // the oriented normals of the triangles does not depend on their common
+  // corner
 
+  // Vectors, centroid and normal of one triangle
+  std::array<double, DIM> a;
+  std::array<double, DIM> b;
+  std::array<double, DIM> triangle_centroid;
+  std::array<double, DIM> triangle_normal;
+  std::array<double, DIM> v_out;  // point always outside
   // Array to store the areas of the triangles
   std::array<double, DIM> sum_up = {0};
   double sum_down = 0.0;  // Sum of the areas of the triangles
+  normal.fill(0.0);
   for (int l = 0; l < number_lines; l++) {
-    const auto& line_start = lines[l].get_start_point();
-    const auto& line_end = lines[l].get_end_point();
+    const auto& line_start = lines[l]->get_start_point();
+    const auto& line_end = lines[l]->get_end_point();
+    const auto& o = lines[l]->get_outside_point();
     // Form the vectors of the triangle
     for (int j = 0; j < DIM; j++) {
       a[j] = line_start[j] - mean_values[j];
       b[j] = line_end[j] - mean_values[j];
       triangle_centroid[j] =
           (line_start[j] + line_end[j] + mean_values[j]) / 3.0;
+      v_out[j] = o[j] - mean_values[j];
     }
-    // Calculate the area of the triangle
-    const double A_l =
-        0.5 * std::sqrt(std::pow(a[x2] * b[x3] - a[x3] * b[x2], 2.0) +
-                        std::pow(a[x1] * b[x3] - a[x3] * b[x1], 2.0) +
-                        std::pow(a[x2] * b[x1] - a[x1] * b[x2], 2.0));
+    // Calculate the area of the triangle from the cross product
+    const double cross1 = a[x2] * b[x3] - a[x3] * b[x2];
+    const double cross2 = a[x1] * b[x3] - a[x3] * b[x1];
+    const double cross3 = a[x2] * b[x1] - a[x1] * b[x2];
+    const double A_l = 0.5 * std::sqrt(std::pow(cross1, 2.0) +
+                                       std::pow(cross2, 2.0) +
+                                       std::pow(cross3, 2.0));
     // Store the area and update the total area
     for (int i = 0; i < DIM; ++i) {
       sum_up[i] += A_l * triangle_centroid[i];
     }
     sum_down += A_l;
+
+    // The normal of the triangle points away from the outside point
+    triangle_normal[x1] = 0.5 * cross1;
+    triangle_normal[x2] = -0.5 * cross2;
+    triangle_normal[x3] = -0.5 * cross3;
+    triangle_normal[const_i] = 0.0;
+    flip_normal_if_needed(triangle_normal, v_out);
+    for (int j = 0; j < DIM; ++j) {
+      normal[j] += triangle_normal[j];
+    }
   }
-  // Determine centroid as a weighted average of the centroids of the triangles
+  // In the case there are only 3 lines, the centroid is the mean of the
+  // corner points and the Polygon is on a plane. Otherwise it is a weighted
+  // average of the centroids of the triangles
   for (int i = 0; i < DIM; i++) {
-    centroid[i] = sum_up[i] / sum_down;
+    centroid[i] = (number_lines == 3) ? mean_values[i] : sum_up[i] / sum_down;
   }
-  centroid_calculated = true;
+  centroid_calculated = normal_calculated = true;
 }
 
 void Polygon::calculate_normal() {
-  // Check if the centroid is calculated
+  const int number_lines = lines.size();
+  // The normal is found together with the centroid, unless the centroid was
+  // given with set_centroid()
   if (!centroid_calculated) {
     calculate_centroid();
+    return;
   }
   // Find the normal vector for all the triangles formed from one edge of the
-  // centroid
-  for (int i = 0; i < number_lines; i++) {
-    for (int j = 0; j < DIM; j++) {
-      normals[i][j] = 0.0;
-    }
-  }
-  std::array<double, DIM> v_out = {0};  // point always outside
+  // centroid. The normal is the sum of the normals of the triangles
+  normal.fill(0.0);
+  std::array<double, DIM> a;
+  std::array<double, DIM> b;
+  std::array<double, DIM> triangle_normal;
+  std::array<double, DIM> v_out;  // point always outside
   // Loop over all triangles
   for (int i = 0; i < number_lines; i++) {
-    const auto& l1 = lines[i].get_start_point();
-    const auto& l2 = lines[i].get_end_point();
+    const auto& l1 = lines[i]->get_start_point();
+    const auto& l2 = lines[i]->get_end_point();
 
     for (int j = 0; j < DIM; j++) {
       a[j] = l1[j] - centroid[j];
       b[j] = l2[j] - centroid[j];
     }
     // Calculate the normal vector of the triangle with cross product
-    normals[i][x1] = 0.5 * (a[x2] * b[x3] - a[x3] * b[x2]);
-    normals[i][x2] = -0.5 * (a[x1] * b[x3] - a[x3] * b[x1]);
-    normals[i][x3] = 0.5 * (a[x1] * b[x2] - a[x2] * b[x1]);
-    normals[i][const_i] = 0.0;
+    triangle_normal[x1] = 0.5 * (a[x2] * b[x3] - a[x3] * b[x2]);
+    triangle_normal[x2] = -0.5 * (a[x1] * b[x3] - a[x3] * b[x1]);
+    triangle_normal[x3] = 0.5 * (a[x1] * b[x2] - a[x2] * b[x1]);
+    triangle_normal[const_i] = 0.0;
 
     // Construct the vector pointing outside the polygon
-    const auto& o = lines[i].get_outside_point();
+    const auto& o = lines[i]->get_outside_point();
     for (int j = 0; j < DIM; ++j) {
       v_out[j] = o[j] - centroid[j];
     }
     // Check if the normal is pointing in the correct direction
-    flip_normal_if_needed(normals[i], v_out);
-  }
-  // The normal is the sum of the normals of the triangles
-  for (int i = 0; i < DIM; i++) {
-    normal[i] = 0.0;
-  }
-  for (int i = 0; i < number_lines; i++) {
+    flip_normal_if_needed(triangle_normal, v_out);
     for (int j = 0; j < DIM; ++j) {
-      normal[j] += normals[i][j];
+      normal[j] += triangle_normal[j];
     }
   }
   normal_calculated = true;
@@ -192,9 +195,9 @@ void Polygon::calculate_normal() {
 
 void Polygon::print(std::ofstream& file, std::array<double, DIM> position) {
   // Print the polygon to the file
-  for (int i = 0; i < number_lines; i++) {
-    const auto& p1 = lines[i].get_start_point();
-    const auto& p2 = lines[i].get_end_point();
+  for (int i = 0; i < lines.size(); i++) {
+    const auto& p1 = lines[i]->get_start_point();
+    const auto& p2 = lines[i]->get_end_point();
     file << position[x1] + p1[x1] << " " << position[x2] + p1[x2] << " "
          << position[x3] + p1[x3] << " " << position[x1] + p2[x1] << " "
          << position[x2] + p2[x2] << " " << position[x3] + p2[x3] << " "
@@ -6,8 +6,10 @@
 #include <cmath>
 #include <fstream>
 #include <numeric>
+#include <type_traits>
 #include <vector>
 
+#include "FixedVector.h"
 #include "GeneralGeometryElement.h"
 #include "Line.h"
 
@@ -18,6 +20,10 @@
  * This class extends the GeneralGeometryElement class and provides methods
  * to manage and calculate properties related to polygons.
  *
+ * The polygon does not copy its lines, it only refers to them. The lines are
+ * owned by the cell which constructs the polygon and have to stay in place
+ * as long as the polygon is used.
+ *
  * 23.08.2024 Hendrik Roch, Haydar Mehryar
  *
  */
@@ -25,18 +31,11 @@ class Polygon : public GeneralGeometryElement {
  protected:
   static constexpr int MAX_LINES =
       24;                   ///< Maximum number of lines in a polygon
-  std::vector<Line> lines;  ///< Vector of lines in the polygon
-  int number_lines;         ///< Number of lines in the polygon
+  FixedVector<Line*, MAX_LINES>
+      lines;  ///< Lines in the polygon, owned by the caller
   int x1, x2, x3;           ///< Indices representing the polygon's dimensions
   int const_i;              ///< Constant index for the polygon
 
-  // Arrays a and b to store the vectors of the triangles
-  std::array<double, DIM> a;                  ///< Vector a of the triangle
-  std::array<double, DIM> b;                  ///< Vector b of the triangle
-  std::array<double, DIM> triangle_centroid;  ///< Centroid of the triangle
-
-  std::array<std::array<double, DIM>, MAX_LINES> normals;  ///< Normal vectors
-
   static constexpr double EPSILON = 1e-10;  ///< Small value for epsilon.
 
  public:
@@ -54,6 +53,16 @@ class Polygon : public GeneralGeometryElement {
    */
   ~Polygon();
 
+  /**
+   * @brief Copying and moving are not supported. The polygon refers to
+   * lines owned by its cell, so a copy would keep referring to the lines of
+   * the original cell.
+   */
+  Polygon(const Polygon&) = delete;
+  Polygon& operator=(const Polygon&) = delete;
+  Polygon(Polygon&&) = delete;
+  Polygon& operator=(Polygon&&) = delete;
+
   /**
    * @brief Initializes the polygon with a constant index.
    *
@@ -64,7 +73,8 @@ class Polygon : public GeneralGeometryElement {
   /**
    * @brief Adds a line to the polygon.
    *
-   * @param new_line The line to be added.
+   * @param new_line The line to be added. It is not copied and has to stay
+   * in place as long as the polygon is used.
    * @param perform_no_check If true, the line is added without connectivity
    * checks.
    * @return True if the line was successfully added, otherwise false.
@@ -76,13 +86,25 @@ class Polygon : public GeneralGeometryElement {
    *
    * @return The number of lines in the polygon.
    */
-  inline int get_number_lines() { return number_lines; }
+  inline int get_number_lines() { return lines.size(); }
+
+  /**
+   * @brief Sets the centroid of the polygon if it is already known, so that
+   * it is not calculated again.
+   *
+   * @param new_centroid The centroid which calculate_centroid() would give.
+   */
+  inline void set_centroid(const std::array<double, DIM>& new_centroid) {
+    centroid = new_centroid;
+    centroid_calculated = true;
+  }
 
   /**
    * @brief Calculates the normal vector of the polygon.
    *
    * This method calculates the normal vector based on the lines and centroid of
-   * the polygon.
+   * the polygon. If the centroid is not known yet, both are calculated
+   * together by calculate_centroid().
    */
   void calculate_normal() override;
 
@@ -90,15 +112,26 @@ class Polygon : public GeneralGeometryElement {
    * @brief Calculates the centroid of the polygon.
    *
    * This method calculates the centroid based on the vertices of the polygon.
+   * The normal is found in the same pass over the triangles, with the mean of
+   * the vertices as their common corner instead of the centroid. It agrees
+   * with calculate_normal() up to rounding.
    */
   void calculate_centroid() override;
 
   /**
    * @brief Gets the lines that form the polygon.
    *
-   * @return A reference to the array of lines in the polygon.
+   * @return A reference to the lines in the polygon.
    */
-  inline std::vector<Line>& get_lines() { return lines; }
+  inline FixedVector<Line*, MAX_LINES>& get_lines() { return lines; }
+
+  /**
+   * @brief Gets one line of the polygon.
+   *
+   * @param index The index of the line, [0,get_number_lines()).
+   * @return A reference to the line.
+   */
+  inline Line& get_line(int index) { return *lines[index]; }
 
   /**
    * @brief Prints the triangles formed from the polygon into a given file.
@@ -110,4 +143,10 @@ class Polygon : public GeneralGeometryElement {
   void print(std::ofstream& file, std::array<double, DIM> position);
 };
 
+static_assert(!std::is_copy_constructible<Polygon>::value &&
+                  !std::is_copy_assignable<Polygon>::value &&
+                  !std::is_move_constructible<Polygon>::value &&
+                  !std::is_move_assignable<Polygon>::value,
+              "Polygon must not be copied or moved.");
+
 #endif  // POLYGON_H
\ No newline at end of file
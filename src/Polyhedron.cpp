@@ -2,45 +2,35 @@
 
 #include <iostream>
 
-Polyhedron::Polyhedron() {
-  polygons.reserve(MAX_POLYGONS);
-  polygons.emplace_back();  // Default to construct 1 Polygon
-}
+Polyhedron::Polyhedron() = default;
 
 Polyhedron::~Polyhedron() = default;
 
 void Polyhedron::init_polyhedron() {
   // Reset the number of polygons and tetrahedrons in the polyhedron
-  number_polygons = number_tetrahedrons = 0;
+  polygons.clear();
+  number_tetrahedrons = 0;
   // Set the flags for normal and centroid calculations to false
   normal_calculated = centroid_calculated = false;
 }
 
 bool Polyhedron::add_polygon(Polygon& new_polygon, bool perform_no_check) {
   // For the first polygon, we don't need to check
-  if (number_polygons == 0 || perform_no_check) {
-    // Ensure there's space in the vector
-    if (number_polygons >= polygons.size()) {
-      polygons.emplace_back();  // Add a new Polygon if needed
-    }
-    polygons[number_polygons++] = new_polygon;
+  if (polygons.empty() || perform_no_check) {
+    polygons.push_back(&new_polygon);
     number_tetrahedrons += new_polygon.get_number_lines();
     return true;
   } else {
     // Check if the current polygon is connected to the last polygon, since
     // the polygons are ordered
-    for (int i = 0; i < number_polygons; i++) {
+    for (int i = 0; i < polygons.size(); i++) {
       const int number_lines1 = new_polygon.get_number_lines();
       // Check if the lines are equal
       for (int j = 0; j < number_lines1; j++) {
-        for (int k = 0; k < polygons[i].get_number_lines(); k++) {
-          if (lines_are_connected(new_polygon.get_lines()[j],
-                                  polygons[i].get_lines()[k])) {
-            // Ensure there's space in the vector
-            if (number_polygons >= polygons.size()) {
-              polygons.emplace_back();  // Add a new Polygon if needed
-            }
-            polygons[number_polygons++] = new_polygon;
+        for (int k = 0; k < polygons[i]->get_number_lines(); k++) {
+          if (lines_are_connected(new_polygon.get_line(j),
+                                  polygons[i]->get_line(k))) {
+            polygons.push_back(&new_polygon);
             number_tetrahedrons += number_lines1;
             return true;
           }
@@ -88,16 +78,49 @@ void Polyhedron::tetrahedron_volume(std::array<double, DIM>& v1,
   n[3] = -(v1[0] * bc12 - v1[1] * bc02 + v1[2] * bc01) * INV_SIX;
 }
 
+void Polyhedron::tetrahedron_volumes(TetrahedronBatch& batch) {
+  // Same operations as in tetrahedron_volume(), one component array at a
+  // time, which leaves the compiler free to vectorize the loop
+  for (int i = 0; i < batch.count; i++) {
+    const auto& v1 = batch.v1;
+    const auto& v2 = batch.v2;
+    const auto& v3 = batch.v3;
+    const double bc01 = v2[0][i] * v3[1][i] - v2[1][i] * v3[0][i];
+    const double bc02 = v2[0][i] * v3[2][i] - v2[2][i] * v3[0][i];
+    const double bc03 = v2[0][i] * v3[3][i] - v2[3][i] * v3[0][i];
+    const double bc12 = v2[1][i] * v3[2][i] - v2[2][i] * v3[1][i];
+    const double bc13 = v2[1][i] * v3[3][i] - v2[3][i] * v3[1][i];
+    const double bc23 = v2[2][i] * v3[3][i] - v2[3][i] * v3[2][i];
+    const double n0 =
+        (v1[1][i] * bc23 - v1[2][i] * bc13 + v1[3][i] * bc12) * INV_SIX;
+    const double n1 =
+        -(v1[0][i] * bc23 - v1[2][i] * bc03 + v1[3][i] * bc02) * INV_SIX;
+    const double n2 =
+        (v1[0][i] * bc13 - v1[1][i] * bc03 + v1[3][i] * bc01) * INV_SIX;
+    const double n3 =
+        -(v1[0][i] * bc12 - v1[1][i] * bc02 + v1[2][i] * bc01) * INV_SIX;
+    batch.volume[i] = std::sqrt(n0 * n0 + n1 * n1 + n2 * n2 + n3 * n3);
+    // The normal points away from the outside point
+    const double dot =
+        n0 * batch.outside[0][i] + n1 * batch.outside[1][i] +
+        n2 * batch.outside[2][i] + n3 * batch.outside[3][i];
+    batch.n[0][i] = (dot < 0) ? -n0 : n0;
+    batch.n[1][i] = (dot < 0) ? -n1 : n1;
+    batch.n[2][i] = (dot < 0) ? -n2 : n2;
+    batch.n[3][i] = (dot < 0) ? -n3 : n3;
+  }
+}
+
 void Polyhedron::calculate_centroid() {
   // Array of 0s to store the mean values
   std::array<double, DIM> mean_values = {0};
 
   // Determine the mean values of the corner points, all points appear twice
-  for (int i = 0; i < number_polygons; i++) {
-    auto& lines = polygons[i].get_lines();
-    for (int j = 0; j < polygons[i].get_number_lines(); j++) {
-      const auto& start_point = lines[j].get_start_point();
-      const auto& end_point = lines[j].get_end_point();
+  for (int i = 0; i < polygons.size(); i++) {
+    Polygon& polygon = *polygons[i];
+    for (int j = 0; j < polygon.get_number_lines(); j++) {
+      const auto& start_point = polygon.get_line(j).get_start_point();
+      const auto& end_point = polygon.get_line(j).get_end_point();
       for (int k = 0; k < DIM; k++) {
         mean_values[k] += start_point[k] + end_point[k];
       }
@@ -107,85 +130,68 @@ void Polyhedron::calculate_centroid() {
     mean_values[k] /= (2.0 * number_tetrahedrons);
   }
 
-  // Temporary arrays
+  // One pass over the tetrahedrons formed from the lines, the centroids of
+  // the polygons and the mean point gives the volume weighted centroid and
+  // also the normal, since the sum of the oriented normals of the
+  // tetrahedrons does not depend on their common corner. The tetrahedrons
+  // are collected into batches, whose normals and volumes are found
+  // together, and the batches are summed up in the original order.
+  TetrahedronBatch batch;
+  std::array<std::array<double, DIM>, TetrahedronBatch::SIZE> cm;
   std::array<double, DIM> sum_up = {0};
   double sum_down = 0.0;
+  normal.fill(0.0);
+  batch.count = 0;
+  auto add_batch = [&]() {
+    tetrahedron_volumes(batch);
+    for (int t = 0; t < batch.count; t++) {
+      const double V_i = batch.volume[t];
+      for (int k = 0; k < DIM; k++) {
+        sum_up[k] += V_i * cm[t][k];
+      }
+      sum_down += V_i;
+      for (int k = 0; k < DIM; k++) {
+        normal[k] += batch.n[k][t];
+      }
+    }
+    batch.count = 0;
+  };
   // Loop over all polygons
-  for (int i = 0; i < number_polygons; ++i) {
-    auto& lines = polygons[i].get_lines();
-    const auto& cent = polygons[i].get_centroid();
+  for (int i = 0; i < polygons.size(); i++) {
+    Polygon& polygon = *polygons[i];
+    const auto& cent = polygon.get_centroid();
     // Loop over all lines in the polygon
-    for (int j = 0; j < polygons[i].get_number_lines(); j++) {
-      const auto& start_point = lines[j].get_start_point();
-      const auto& end_point = lines[j].get_end_point();
-      // Center of mass of the tetrahedron
+    for (int j = 0; j < polygon.get_number_lines(); j++) {
+      Line& line = polygon.get_line(j);
+      const auto& start_point = line.get_start_point();
+      const auto& end_point = line.get_end_point();
+      const auto& o = line.get_outside_point();
+      const int t = batch.count;
       for (int k = 0; k < DIM; k++) {
-        cm_i[k] =
+        // Center of mass of the tetrahedron
+        cm[t][k] =
             (start_point[k] + end_point[k] + cent[k] + mean_values[k]) * 0.25;
-        // Compute the defining vectors of the tetrahedron
-        a[k] = start_point[k] - mean_values[k];
-        b[k] = end_point[k] - mean_values[k];
-        c[k] = cent[k] - mean_values[k];
+        // Defining vectors of the tetrahedron and a point always outside
+        batch.v1[k][t] = start_point[k] - mean_values[k];
+        batch.v2[k][t] = end_point[k] - mean_values[k];
+        batch.v3[k][t] = cent[k] - mean_values[k];
+        batch.outside[k][t] = o[k] - mean_values[k];
       }
-      // Calculate the volume of the tetrahedron
-      tetrahedron_volume(a, b, c, n);
-      const double V_i =
-          std::sqrt(std::inner_product(n.begin(), n.end(), n.begin(), 0.0));
-      // Add the contribution to the sum
-      for (int i = 0; i < DIM; i++) {
-        sum_up[i] += V_i * cm_i[i];
+      if (++batch.count == TetrahedronBatch::SIZE) {
+        add_batch();
       }
-      sum_down += V_i;
     }
   }
+  add_batch();
   // Centroid of the polygon is the volume weighted average of the individual
   // tetrahedrons
   for (int i = 0; i < DIM; i++) {
     centroid[i] = sum_up[i] / sum_down;
   }
-  centroid_calculated = true;
+  centroid_calculated = normal_calculated = true;
 }
 
 void Polyhedron::calculate_normal() {
-  if (!centroid_calculated) {
-    calculate_centroid();
-  }
-  int index_tetrahedron = 0;
-  // Loop over all polygons
-  for (int i = 0; i < number_polygons; i++) {
-    auto& lines = polygons[i].get_lines();
-    const auto& cent = polygons[i].get_centroid();
-    // Loop over all lines in the polygon
-    for (int j = 0; j < polygons[i].get_number_lines(); j++) {
-      const auto& start_point = lines[j].get_start_point();
-      const auto& end_point = lines[j].get_end_point();
-
-      // Construct vector pointing outside the polygon
-      const auto& o = lines[j].get_outside_point();
-
-      // Compute the defining vectors of the tetrahedron
-      // Compute defining vectors of the tetrahedron
-      for (int k = 0; k < DIM; ++k) {
-        a[k] = start_point[k] - centroid[k];
-        b[k] = end_point[k] - centroid[k];
-        c[k] = cent[k] - centroid[k];
-
-        Vout[k] = o[k] - centroid[k];
-      }
-      // Normal vector is calculated with the same function as the volume
-      tetrahedron_volume(a, b, c, normals[index_tetrahedron]);
-
-      // Check if the normal is pointing in the correct direction
-      flip_normal_if_needed(normals[index_tetrahedron], Vout);
-      index_tetrahedron++;
-    }
-  }
-  // The normal is the sum of the normals of the tetrahedrons
-  for (int i = 0; i < DIM; i++) {
-    normal[i] = 0.0;
-    for (int j = 0; j < number_tetrahedrons; j++) {
-      normal[i] += normals[j][i];
-    }
-  }
-  normal_calculated = true;
-}
\ No newline at end of file
+  // The normal is found together with the centroid
+  calculate_centroid();
+}
@@ -5,8 +5,10 @@
 #include <array>
 #include <cmath>
 #include <numeric>
+#include <type_traits>
 #include <vector>
 
+#include "FixedVector.h"
 #include "GeneralGeometryElement.h"
 #include "Line.h"
 #include "Polygon.h"
@@ -20,6 +22,11 @@
  * equality, calculating the volume of tetrahedrons, and calculating the
  * centroid and normal.
  *
+ * The polyhedron refers to its polygons instead of copying them, so building
+ * a polyhedron moves no geometry. The polygons are owned by the cell which
+ * constructs the polyhedron and have to stay in place as long as the
+ * polyhedron is used.
+ *
  * 23.08.2024 Hendrik Roch, Haydar Mehryar
  *
  */
@@ -29,21 +36,10 @@ class Polyhedron : public GeneralGeometryElement {
       24;  ///< Maximum number of polygons in a polyhedron
   static constexpr double INV_SIX = 1.0 / 6.0;  ///< Inverse of six.
   static constexpr double EPSILON = 1e-10;  ///< Epsilon value for comparison
-  std::vector<Polygon>
-      polygons;             ///< Vector to store the polygons in the polyhedron
-  int number_polygons;      ///< Number of polygons in the polyhedron
+  FixedVector<Polygon*, MAX_POLYGONS>
+      polygons;  ///< Polygons in the polyhedron, owned by the caller
   int number_tetrahedrons;  ///< Number of tetrahedrons in the polyhedron
 
-  // Arrays for temporary storage
-  std::array<double, DIM> Vout;  ///< Point outside the surface
-  std::array<double, DIM> a;     ///< Vector a of the triangle
-  std::array<double, DIM> b;     ///< Vector b of the triangle
-  std::array<double, DIM> c;     ///< Centroid of the triangle
-  std::array<double, DIM> n;     ///< Normal vector of the triangle
-  std::array<double, DIM> cm_i;  ///< Center of mass of the tetrahedron
-  std::array<std::array<double, DIM>, MAX_POLYGONS * 24>
-      normals;  ///< Normal vectors
-
  public:
   /**
    * @brief Constructs a Polyhedron object.
@@ -55,6 +51,16 @@ class Polyhedron : public GeneralGeometryElement {
    */
   ~Polyhedron();
 
+  /**
+   * @brief Copying and moving are not supported. The polyhedron refers to
+   * polygons owned by its cell, so a copy would keep referring to the
+   * polygons of the original cell.
+   */
+  Polyhedron(const Polyhedron&) = delete;
+  Polyhedron& operator=(const Polyhedron&) = delete;
+  Polyhedron(Polyhedron&&) = delete;
+  Polyhedron& operator=(Polyhedron&&) = delete;
+
   /**
    * @brief Initializes the polyhedron.
    *
@@ -66,7 +72,8 @@ class Polyhedron : public GeneralGeometryElement {
   /**
    * @brief Adds a polygon to the polyhedron.
    *
-   * @param new_polygon The polygon to add.
+   * @param new_polygon The polygon to add. It is not copied and has to stay
+   * in place as long as the polyhedron is used.
    * @param perform_no_check If true, adds the polygon without checking for
    * connection to existing polygons.
    * @return True if the polygon was added successfully, false otherwise.
@@ -96,11 +103,39 @@ class Polyhedron : public GeneralGeometryElement {
                           std::array<double, DIM>& v3,
                           std::array<double, DIM>& n);
 
+  /**
+   * @brief Tetrahedrons in structure of arrays layout, i.e. each component
+   * of the defining vectors of all tetrahedrons is one contiguous array.
+   */
+  struct TetrahedronBatch {
+    static constexpr int SIZE = 32;  ///< Maximum number of tetrahedrons.
+    using Component = std::array<double, SIZE>;
+    alignas(64) std::array<Component, DIM> v1;       ///< First vectors.
+    alignas(64) std::array<Component, DIM> v2;       ///< Second vectors.
+    alignas(64) std::array<Component, DIM> v3;       ///< Third vectors.
+    alignas(64) std::array<Component, DIM> outside;  ///< Outside vectors.
+    alignas(64) std::array<Component, DIM> n;        ///< Normals, the result.
+    alignas(64) Component volume;                    ///< Volumes, the result.
+    int count;  ///< Number of tetrahedrons in the batch.
+  };
+
+  /**
+   * @brief Calculates the normals and volumes of a batch of tetrahedrons.
+   *
+   * Each normal is the one given by tetrahedron_volume(), pointing away from
+   * the outside vector of the tetrahedron.
+   *
+   * @param batch The tetrahedrons. The normals and volumes are written to
+   * it.
+   */
+  static void tetrahedron_volumes(TetrahedronBatch& batch);
+
   /**
    * @brief Calculates the centroid of the polyhedron.
    *
    * Computes the centroid as the volume-weighted average of the individual
-   * tetrahedrons.
+   * tetrahedrons, which are formed with the mean of the vertices as their
+   * common corner. The normal is found in the same pass.
    */
   void calculate_centroid() override;
 
@@ -108,7 +143,9 @@ class Polyhedron : public GeneralGeometryElement {
    * @brief Calculates the normal of the polyhedron.
    *
    * Computes the normal as the sum of the normals of the individual
-   * tetrahedrons.
+   * tetrahedrons, together with the centroid. Using the mean of the vertices
+   * instead of the centroid as the common corner of the tetrahedrons changes
+   * the result only by rounding.
    */
   void calculate_normal() override;
 
@@ -117,7 +154,7 @@ class Polyhedron : public GeneralGeometryElement {
    *
    * @return The number of polygons in the polyhedron.
    */
-  inline int get_number_polygons() { return number_polygons; }
+  inline int get_number_polygons() { return polygons.size(); }
 
   /**
    * @brief Retrieves the number of tetrahedrons in the polyhedron.
@@ -125,6 +162,29 @@ class Polyhedron : public GeneralGeometryElement {
    * @return The number of tetrahedrons in the polyhedron.
    */
   inline int get_number_tetrahedrons() { return number_tetrahedrons; }
+
+  /**
+   * @brief Gets the polygons of the polyhedron.
+   *
+   * @return A reference to the polygons.
+   */
+  inline FixedVector<Polygon*, MAX_POLYGONS>& get_polygons() {
+    return polygons;
+  }
+
+  /**
+   * @brief Gets one polygon of the polyhedron.
+   *
+   * @param index The index of the polygon, [0,get_number_polygons()).
+   * @return A reference to the polygon.
+   */
+  inline Polygon& get_polygon(int index) { return *polygons[index]; }
 };
 
+static_assert(!std::is_copy_constructible<Polyhedron>::value &&
+                  !std::is_copy_assignable<Polyhedron>::value &&
+                  !std::is_move_constructible<Polyhedron>::value &&
+                  !std::is_move_assignable<Polyhedron>::value,
+              "Polyhedron must not be copied or moved.");
+
 #endif  // POLYHEDRON_H
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "SliceRange.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+SliceRange::SliceRange()
+    : number_planes(0),
+      lines_per_plane(0),
+      line_size(0),
+      words_per_line(1),
+      value(0.0) {}
+
+SliceRange::~SliceRange() = default;
+
+void SliceRange::init_slice_range(int new_number_planes,
+                                  int new_lines_per_plane,
+                                  std::size_t new_line_size) {
+  number_planes = new_number_planes;
+  lines_per_plane = new_lines_per_plane;
+  line_size = new_line_size;
+  words_per_line = (line_size + WORD - 1) / WORD + 1;
+  const std::size_t number_lines =
+      static_cast<std::size_t>(number_planes) * lines_per_plane;
+  planes.resize(number_planes);
+  lines.resize(number_lines);
+  signs.resize(number_lines * words_per_line);
+}
+
+void SliceRange::build(const double* slice, double new_value) {
+  value = new_value;
+  for (int plane = 0; plane < number_planes; plane++) {
+    Range& plane_range = planes[plane];
+    plane_range = empty_range();
+    for (int line = 0; line < lines_per_plane; line++) {
+      const std::size_t index =
+          static_cast<std::size_t>(plane) * lines_per_plane + line;
+      const double* values = slice + index * line_size;
+      std::uint64_t* words = signs.data() + index * words_per_line;
+      Range& line_range = lines[index];
+      line_range = empty_range();
+      for (std::size_t w = 0; w + 1 < words_per_line; w++) {
+        const std::size_t begin = w * WORD;
+        const int number_points =
+            static_cast<int>(std::min<std::size_t>(WORD, line_size - begin));
+        Range word_range;
+        words[w] = scan_word(values + begin, number_points, word_range);
+        merge(line_range, word_range);
+      }
+      words[words_per_line - 1] = 0;
+      merge(plane_range, line_range);
+    }
+  }
+}
+
+std::uint64_t SliceRange::scan_word(const double* values, int number_points,
+                                    Range& range) const {
+  const double lowest = -std::numeric_limits<double>::infinity();
+  std::uint64_t word = 0;
+  range = empty_range();
+  int p = 0;
+#if defined(__SSE2__)
+  // Two pairs of points at a time. The compare is false for NaN, and min
+  // and max keep their second operand if the first one is NaN.
+  const __m128d threshold = _mm_set1_pd(value);
+  __m128d min0 = _mm_set1_pd(range.min);
+  __m128d min1 = min0;
+  __m128d max0 = _mm_set1_pd(range.max);
+  __m128d max1 = max0;
+  __m128d not_a_number = _mm_setzero_pd();
+  for (; p + 4 <= number_points; p += 4) {
+    const __m128d a = _mm_loadu_pd(values + p);
+    const __m128d b = _mm_loadu_pd(values + p + 2);
+    const int bits = _mm_movemask_pd(_mm_cmpge_pd(a, threshold)) |
+                     (_mm_movemask_pd(_mm_cmpge_pd(b, threshold)) << 2);
+    word |= static_cast<std::uint64_t>(bits) << p;
+    min0 = _mm_min_pd(a, min0);
+    min1 = _mm_min_pd(b, min1);
+    max0 = _mm_max_pd(a, max0);
+    max1 = _mm_max_pd(b, max1);
+    not_a_number = _mm_or_pd(
+        not_a_number, _mm_or_pd(_mm_cmpunord_pd(a, a), _mm_cmpunord_pd(b, b)));
+  }
+  std::array<double, 2> mins;
+  std::array<double, 2> maxs;
+  _mm_storeu_pd(mins.data(), _mm_min_pd(min0, min1));
+  _mm_storeu_pd(maxs.data(), _mm_max_pd(max0, max1));
+  range = {std::min(mins[0], mins[1]), std::max(maxs[0], maxs[1])};
+  if (_mm_movemask_pd(not_a_number) != 0) {
+    range.min = lowest;
+  }
+#endif
+  for (; p < number_points; p++) {
+    const double x = values[p];
+    word |= static_cast<std::uint64_t>(x >= value) << p;
+    // std::max() skips NaN, but the minimum has to be lowered for it
+    range.min = std::min(range.min, (x == x) ? x : lowest);
+    range.max = std::max(range.max, x);
+  }
+  return word;
+}
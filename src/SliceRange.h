@@ -0,0 +1,186 @@
+#ifndef SLICE_RANGE_H
+#define SLICE_RANGE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @class SliceRange
+ * @brief Smallest and largest value in the parts of one time slice, and the
+ * sign of every point relative to the value of the surface.
+ *
+ * A time slice is split into planes with the same index in the first spatial
+ * direction, and each plane into lines of points along the last direction.
+ * The range of the values is kept for each plane and for each line, so a
+ * lattice search can skip a whole row of cells, or a line of cells in it, if
+ * the value of the surface is outside of the range of all its corners.
+ *
+ * Below the lines, one bit is kept for each point, set if the point is at or
+ * above the value. The bits of a line are packed into 64-bit words. The
+ * corners of 64 neighbouring cells are then compared with a few word
+ * operations, and the bits of a cell give its corner pattern.
+ *
+ * A point whose value is NaN is never at or above the value of the surface,
+ * so its bit is not set, it lowers the smallest value of its line and plane
+ * to minus infinity and it is ignored for the largest value.
+ *
+ */
+class SliceRange {
+ public:
+  /**
+   * @brief Smallest and largest value of a part of the slice.
+   */
+  struct Range {
+    double min;  ///< Smallest value
+    double max;  ///< Largest value
+  };
+
+  static constexpr int WORD = 64;  ///< Number of points in a word.
+
+ private:
+  int number_planes;       ///< Number of planes in the slice.
+  int lines_per_plane;     ///< Number of lines in one plane.
+  std::size_t line_size;   ///< Number of points in one line.
+  std::size_t words_per_line;  ///< Words of a line, with one zero word.
+  double value;                ///< Value of the surface for the signs.
+  std::vector<Range> planes;   ///< Range of each plane.
+  std::vector<Range> lines;    ///< Range of each line.
+  std::vector<std::uint64_t> signs;  ///< Sign bits of each line.
+
+  /**
+   * @brief Finds the sign bits and the range of up to 64 points.
+   *
+   * @param values Values of the points.
+   * @param number_points Number of points, [1,64].
+   * @param range Range of the points.
+   * @return The sign bits of the points.
+   */
+  std::uint64_t scan_word(const double* values, int number_points,
+                          Range& range) const;
+
+ public:
+  /**
+   * @brief Default constructor for the SliceRange class. The slice is empty.
+   */
+  SliceRange();
+
+  /**
+   * @brief Destructor for the SliceRange class.
+   */
+  ~SliceRange();
+
+  /**
+   * @brief Sets the shape of the slice.
+   *
+   * @param new_number_planes Number of planes in the slice.
+   * @param new_lines_per_plane Number of lines in one plane.
+   * @param new_line_size Number of points in one line.
+   */
+  void init_slice_range(int new_number_planes, int new_lines_per_plane,
+                        std::size_t new_line_size);
+
+  /**
+   * @brief Finds the ranges of all planes and lines of a slice, and the
+   * signs of its points.
+   *
+   * @param slice Values of the slice, plane after plane and line after line.
+   * @param new_value The value of the surface.
+   */
+  void build(const double* slice, double new_value);
+
+  /**
+   * @brief Gets the number of planes in the slice.
+   * @return The number of planes.
+   */
+  inline int get_number_planes() const { return number_planes; }
+
+  /**
+   * @brief Gets the number of lines in one plane.
+   * @return The number of lines.
+   */
+  inline int get_lines_per_plane() const { return lines_per_plane; }
+
+  /**
+   * @brief Gets the number of points in one line.
+   * @return The number of points.
+   */
+  inline std::size_t get_line_size() const { return line_size; }
+
+  /**
+   * @brief Gets the value of the surface the signs were found for.
+   * @return The value.
+   */
+  inline double get_value() const { return value; }
+
+  /**
+   * @brief Gets the range of a whole plane.
+   * @param plane Index of the plane, [0,number of planes).
+   * @return The range of the plane.
+   */
+  inline const Range& get_plane_range(int plane) const {
+    return planes[plane];
+  }
+
+  /**
+   * @brief Gets the range of a line.
+   * @param plane Index of the plane, [0,number of planes).
+   * @param line Index of the line in the plane, [0,lines per plane).
+   * @return The range of the line.
+   */
+  inline const Range& get_line_range(int plane, int line) const {
+    return lines[static_cast<std::size_t>(plane) * lines_per_plane + line];
+  }
+
+  /**
+   * @brief Gets the sign bits of a line.
+   *
+   * Bit b of word w is set if the point 64 * w + b of the line is at or
+   * above the value. The word after the last one which holds points is zero.
+   *
+   * @param plane Index of the plane, [0,number of planes).
+   * @param line Index of the line in the plane, [0,lines per plane).
+   * @return Pointer to the first word of the line.
+   */
+  inline const std::uint64_t* get_signs(int plane, int line) const {
+    return signs.data() +
+           (static_cast<std::size_t>(plane) * lines_per_plane + line) *
+               words_per_line;
+  }
+
+  /**
+   * @brief Widens a range so that it also contains another one.
+   * @param range Range which is widened.
+   * @param other Range which is added.
+   */
+  static inline void merge(Range& range, const Range& other) {
+    range.min = std::min(range.min, other.min);
+    range.max = std::max(range.max, other.max);
+  }
+
+  /**
+   * @brief Checks if a surface may cross points with values in a range.
+   *
+   * @param range Range of the values.
+   * @param value The value of the surface.
+   * @return False if all values are below the value, or all values are at or
+   * above it.
+   */
+  static inline bool may_cross(const Range& range, double value) {
+    return range.max >= value && range.min < value;
+  }
+
+  /**
+   * @brief Gets a range which contains no value.
+   * @return The empty range.
+   */
+  static inline Range empty_range() {
+    return {std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity()};
+  }
+};
+
+#endif  // SLICE_RANGE_H
@@ -1,6 +1,6 @@
 #include "Square.h"
 
-Square::Square() : ambiguous(false) {}
+Square::Square() : given_cuts(nullptr), ambiguous(false) {}
 
 Square::~Square() = default;
 
@@ -70,48 +70,35 @@ void Square::construct_lines(double value) {
 }
 
 void Square::ends_of_edge(double value) {
-  const double top_left = points[0][0] - value;
-  const double top_right = points[0][1] - value;
-  const double bottom_left = points[1][0] - value;
-  const double bottom_right = points[1][1] - value;
+  // Cuts of the four edges, each from its lower to its upper corner
+  std::array<double, MAX_POINTS> edge_cut_values;
+  const double* edge_cuts_square = given_cuts;
+  if (edge_cuts_square == nullptr) {
+    const std::array<double, MAX_POINTS> values_low = {
+        points[0][0], points[0][0], points[1][0], points[0][1]};
+    const std::array<double, MAX_POINTS> values_high = {
+        points[1][0], points[0][1], points[1][1], points[1][1]};
+    const std::array<double, MAX_POINTS> delta_x = {dx[x1], dx[x2], dx[x2],
+                                                    dx[x1]};
+    edge_cuts(MAX_POINTS, values_low.data(), values_high.data(), value,
+              delta_x.data(), edge_cut_values.data());
+    edge_cuts_square = edge_cut_values.data();
+  }
   // Edge 1
-  if (top_left * bottom_left < 0) {
-    add_cut(std::array<double, SQUARE_DIM>{
-        top_left / (points[0][0] - points[1][0]) * dx[x1], 0});
-  } else if (points[0][0] == value && points[1][0] < value) {
-    add_cut(std::array<double, SQUARE_DIM>{ALMOST_ZERO * dx[x1], 0});
-  } else if (points[1][0] == value && points[0][0] < value) {
-    add_cut(std::array<double, SQUARE_DIM>{ALMOST_ONE * dx[x1], 0});
+  if (!std::isnan(edge_cuts_square[0])) {
+    add_cut(std::array<double, SQUARE_DIM>{edge_cuts_square[0], 0}, 0);
   }
-
   // Edge 2
-  if (top_left * top_right < 0) {
-    add_cut(std::array<double, SQUARE_DIM>{
-        0, top_left / (points[0][0] - points[0][1]) * dx[x2]});
-  } else if (points[0][0] == value && points[0][1] < value) {
-    add_cut(std::array<double, SQUARE_DIM>{0, ALMOST_ZERO * dx[x2]});
-  } else if (points[0][1] == value && points[0][0] < value) {
-    add_cut(std::array<double, SQUARE_DIM>{0, ALMOST_ONE * dx[x2]});
+  if (!std::isnan(edge_cuts_square[1])) {
+    add_cut(std::array<double, SQUARE_DIM>{0, edge_cuts_square[1]}, 1);
   }
-
   // Edge 3
-  if (bottom_left * bottom_right < 0) {
-    add_cut(std::array<double, SQUARE_DIM>{
-        dx[x1], bottom_left / (points[1][0] - points[1][1]) * dx[x2]});
-  } else if (points[1][0] == value && points[1][1] < value) {
-    add_cut(std::array<double, SQUARE_DIM>{dx[x1], ALMOST_ZERO * dx[x2]});
-  } else if (points[1][1] == value && points[1][0] < value) {
-    add_cut(std::array<double, SQUARE_DIM>{dx[x1], ALMOST_ONE * dx[x2]});
+  if (!std::isnan(edge_cuts_square[2])) {
+    add_cut(std::array<double, SQUARE_DIM>{dx[x1], edge_cuts_square[2]}, 2);
   }
-
   // Edge 4
-  if (top_right * bottom_right < 0) {
-    add_cut(std::array<double, SQUARE_DIM>{
-        top_right / (points[0][1] - points[1][1]) * dx[x1], dx[x2]});
-  } else if (points[0][1] == value && points[1][1] < value) {
-    add_cut(std::array<double, SQUARE_DIM>{ALMOST_ZERO * dx[x1], dx[x2]});
-  } else if (points[1][1] == value && points[0][1] < value) {
-    add_cut(std::array<double, SQUARE_DIM>{ALMOST_ONE * dx[x1], dx[x2]});
+  if (!std::isnan(edge_cuts_square[3])) {
+    add_cut(std::array<double, SQUARE_DIM>{edge_cuts_square[3], dx[x2]}, 3);
   }
 
   if (number_cuts != 0 && number_cuts != 2 && number_cuts != 4) {
@@ -141,6 +128,7 @@ void Square::find_outside(double value) {
     if ((points[0][0] < value && value_middle < value) ||
         (points[0][0] > value && value_middle > value)) {
       std::swap(cuts[1], cuts[2]);
+      std::swap(cut_edges[1], cut_edges[2]);
     }
 
     // The center is below, so the middle point is always outside the surface
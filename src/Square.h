@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <numeric>
 
 #include "GeneralGeometryElement.h"
@@ -34,6 +36,8 @@ class Square : public GeneralGeometryElement {
       points;  ///< Points of the square.
   std::array<std::array<double, SQUARE_DIM>, MAX_POINTS>
       cuts;  ///< Points of the cuts.
+  std::array<int, MAX_POINTS>
+      cut_edges;  ///< Edges of the cuts in the order of ends_of_edge().
   std::array<std::array<double, SQUARE_DIM>, MAX_POINTS>
       out;                                    ///< Points outside the square.
   std::array<int, DIM - SQUARE_DIM> const_i;  ///< Indices for constraints.
@@ -44,6 +48,7 @@ class Square : public GeneralGeometryElement {
   int number_cuts;                    ///< Number of cuts.
   int number_lines;                   ///< Number of lines.
   std::array<Line, MAX_LINES> lines;  ///< Lines in the square.
+  const double* given_cuts;           ///< Cuts computed by the caller, if any.
   bool ambiguous;                     ///< Indicates if the square is ambiguous.
 
   std::array<std::array<double, DIM>, SQUARE_DIM>
@@ -73,6 +78,68 @@ class Square : public GeneralGeometryElement {
                    std::array<double, DIM - SQUARE_DIM>& c_v,
                    std::array<double, DIM>& dex);
 
+  /**
+   * @brief Finds the cut point on an edge.
+   *
+   * The edge is cut if its corners are on different sides of the value. If
+   * one corner is exactly at the value and the other one below it, the cut
+   * is moved just inside the edge from the corner at the value. The result
+   * is selected without branches, so that loops over many edges can be
+   * vectorized.
+   *
+   * @param value_low Value at the lower corner of the edge.
+   * @param value_high Value at the upper corner of the edge.
+   * @param value The value of the surface.
+   * @param delta_x Length of the edge.
+   * @return Position of the cut relative to the lower corner, or NaN if the
+   * edge is not cut.
+   */
+  static inline double edge_cut(double value_low, double value_high,
+                                double value, double delta_x) {
+    const double interpolated =
+        (value_low - value) / (value_low - value_high) * delta_x;
+    const bool crossed = (value_low - value) * (value_high - value) < 0;
+    const bool at_low = (value_low == value) & (value_high < value);
+    const bool at_high = (value_high == value) & (value_low < value);
+    double cut = std::numeric_limits<double>::quiet_NaN();
+    cut = at_low ? ALMOST_ZERO * delta_x : cut;
+    cut = at_high ? ALMOST_ONE * delta_x : cut;
+    return crossed ? interpolated : cut;
+  }
+
+  /**
+   * @brief Finds the cut points on many edges with edge_cut().
+   *
+   * The edges are given in structure of arrays layout and gone through in
+   * one loop without branches, which the compiler vectorizes.
+   *
+   * @param number_edges Number of edges.
+   * @param values_low Values at the lower corners of the edges.
+   * @param values_high Values at the upper corners of the edges.
+   * @param value The value of the surface.
+   * @param delta_x Lengths of the edges.
+   * @param cuts Position of the cut on each edge, or NaN if it is not cut.
+   */
+  static inline void edge_cuts(int number_edges, const double* values_low,
+                               const double* values_high, double value,
+                               const double* delta_x, double* cuts) {
+    for (int i = 0; i < number_edges; i++) {
+      cuts[i] = edge_cut(values_low[i], values_high[i], value, delta_x[i]);
+    }
+  }
+
+  /**
+   * @brief Sets the cuts of the edges of the square, so that they are not
+   * computed again.
+   *
+   * The cuts are used by the next calls of construct_lines() until they are
+   * reset with a null pointer.
+   *
+   * @param cuts Position of the cut on each of the 4 edges relative to its
+   * lower corner as given by edge_cut(), in the order of ends_of_edge().
+   */
+  inline void set_edge_cuts(const double* cuts) { given_cuts = cuts; }
+
   /**
    * @brief Constructs lines within the square based on a given value.
    * @param value The value used to construct lines.
@@ -83,9 +150,12 @@ class Square : public GeneralGeometryElement {
    * @brief Adds a new cut point to the square.
    * @param cut A `std::array` of size `SQUARE_DIM` representing the cut point
    * coordinates.
+   * @param edge Index of the edge of the cut, [0,4) in the order of
+   * ends_of_edge().
    */
-  inline void add_cut(const std::array<double, SQUARE_DIM>& cut) {
+  inline void add_cut(const std::array<double, SQUARE_DIM>& cut, int edge) {
     if (number_cuts < MAX_POINTS) {
+      cut_edges[number_cuts] = edge;
       cuts[number_cuts++] = cut;
     } else {
       std::cerr << "Error: Maximum number of cuts exceeded." << std::endl;
@@ -107,6 +177,9 @@ class Square : public GeneralGeometryElement {
    * Since in the case where the ends are on each edge the ends are
    * assumed to be connected like \\
    *
+   * The cuts of all four edges are found together with edge_cuts(), unless
+   * they are given with set_edge_cuts().
+   *
    * @param value The value used to find ends of edges.
    */
   void ends_of_edge(double value);
@@ -134,6 +207,16 @@ class Square : public GeneralGeometryElement {
    * @return A reference to the array of lines.
    */
   inline std::array<Line, MAX_LINES>& get_lines() { return lines; }
+
+  /**
+   * @brief Gets the edges on which a line starts and ends.
+   * @param line Index of the line.
+   * @return The indices of the edges of the start and end point, [0,4) in
+   * the order of ends_of_edge().
+   */
+  inline std::array<int, 2> get_line_edges(int line) const {
+    return {cut_edges[2 * line], cut_edges[2 * line + 1]};
+  }
 };
 
 #endif  // SQUARE_H
\ No newline at end of file
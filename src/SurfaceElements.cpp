@@ -0,0 +1,53 @@
+#include "SurfaceElements.h"
+
+SurfaceElements::SurfaceElements() : dimension(DIM), number_elements(0) {}
+
+SurfaceElements::~SurfaceElements() = default;
+
+void SurfaceElements::init_elements(int new_dimension, int capacity) {
+  dimension = new_dimension;
+  clear();
+  for (int i = 0; i < DIM; i++) {
+    normals[i].reserve(capacity);
+    centroids[i].reserve(capacity);
+  }
+}
+
+SurfaceElements::Span SurfaceElements::get_normal_component(
+    int component) const {
+  if (component < 0 || component >= dimension) {
+    throw std::out_of_range(
+        "SurfaceElements error: asking for a component which does not exist.");
+  }
+  return {normals[component + (DIM - dimension)].data(), number_elements};
+}
+
+SurfaceElements::Span SurfaceElements::get_centroid_component(
+    int component) const {
+  if (component < 0 || component >= dimension) {
+    throw std::out_of_range(
+        "SurfaceElements error: asking for a component which does not exist.");
+  }
+  return {centroids[component + (DIM - dimension)].data(), number_elements};
+}
+
+double SurfaceElements::get_centroid_element(int index_surface_element,
+                                             int element_centroid) const {
+  if (index_surface_element >= number_elements ||
+      element_centroid >= dimension) {
+    throw std::out_of_range(
+        "SurfaceElements error: asking for an element which does not exist.");
+  }
+  return centroids[element_centroid + (DIM - dimension)]
+                  [index_surface_element];
+}
+
+double SurfaceElements::get_normal_element(int index_surface_element,
+                                           int element_normal) const {
+  if (index_surface_element >= number_elements ||
+      element_normal >= dimension) {
+    throw std::out_of_range(
+        "SurfaceElements error: asking for an element which does not exist.");
+  }
+  return normals[element_normal + (DIM - dimension)][index_surface_element];
+}
@@ -0,0 +1,148 @@
+#ifndef SURFACE_ELEMENTS_H
+#define SURFACE_ELEMENTS_H
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @class SurfaceElements
+ * @brief Container for surface elements in structure of arrays layout.
+ *
+ * Each component of the normal vectors (\sigma_\mu) and of the centroids is
+ * stored in its own contiguous array, i.e. the component mu of all elements
+ * can be read out as one span. The arrays keep their memory when the
+ * container is cleared, so a container which is reused for many cells does
+ * not allocate once it has reached its largest size.
+ *
+ * The elements are given to add_element() in the padded form used by the
+ * geometry classes, where the first DIM - dimension entries are unused. The
+ * accessors take the component index of the problem, i.e. [0,dimension).
+ *
+ */
+class SurfaceElements {
+ private:
+  static constexpr int DIM = 4; /**< Dimension of the space (default is 4D) */
+
+  int dimension;       /**< Dimension of the problem (2, 3, or 4) */
+  int number_elements; /**< Number of elements stored */
+  std::array<std::vector<double>, DIM>
+      normals; /**< Components of the normals, one array per component */
+  std::array<std::vector<double>, DIM>
+      centroids; /**< Components of the centroids, one array per component */
+
+ public:
+  /**
+   * @brief Read-only view of one component of all elements.
+   */
+  struct Span {
+    const double* data;  ///< First value of the component
+    int count;           ///< Number of values
+
+    inline const double& operator[](int i) const { return data[i]; }
+    inline int size() const { return count; }
+    inline const double* begin() const { return data; }
+    inline const double* end() const { return data + count; }
+  };
+
+  /**
+   * @brief Default constructor for the SurfaceElements class.
+   */
+  SurfaceElements();
+
+  /**
+   * @brief Destructor for the SurfaceElements class.
+   */
+  ~SurfaceElements();
+
+  /**
+   * @brief Sets the dimension and discards all elements.
+   *
+   * @param new_dimension The dimension of the problem (2, 3, or 4).
+   * @param capacity Number of elements for which memory is reserved.
+   */
+  void init_elements(int new_dimension, int capacity);
+
+  /**
+   * @brief Discards all elements. The memory is kept.
+   */
+  inline void clear() {
+    number_elements = 0;
+    for (int i = 0; i < DIM; i++) {
+      normals[i].clear();
+      centroids[i].clear();
+    }
+  }
+
+  /**
+   * @brief Adds one element at the end.
+   *
+   * @param normal Normal vector of the element in padded form.
+   * @param centroid Centroid of the element in padded form.
+   */
+  inline void add_element(const std::array<double, DIM>& normal,
+                          const std::array<double, DIM>& centroid) {
+    for (int i = DIM - dimension; i < DIM; i++) {
+      normals[i].push_back(normal[i]);
+      centroids[i].push_back(centroid[i]);
+    }
+    number_elements++;
+  }
+
+  /**
+   * @brief Gets the dimension of the problem.
+   *
+   * @return The dimension.
+   */
+  inline int get_dimension() const { return dimension; }
+
+  /**
+   * @brief Gets the number of elements stored.
+   *
+   * @return The number of elements.
+   */
+  inline int get_number_elements() const { return number_elements; }
+
+  /**
+   * @brief Gets one component of the normals of all elements.
+   *
+   * @param component The index of the component. Valid values are
+   *               [0,dimension of the problem].
+   * @return A view of the component, valid until the container is changed.
+   */
+  Span get_normal_component(int component) const;
+
+  /**
+   * @brief Gets one component of the centroids of all elements.
+   *
+   * @param component The index of the component. Valid values are
+   *               [0,dimension of the problem].
+   * @return A view of the component, valid until the container is changed.
+   */
+  Span get_centroid_component(int component) const;
+
+  /**
+   * @brief Gets a specific centroid element.
+   *
+   * @param index_surface_element The index of the surface element.
+   * @param element_centroid The index of the centroid element. Valid values are
+   *               [0,dimension of the problem].
+   * @return The value of the specified centroid element.
+   */
+  double get_centroid_element(int index_surface_element,
+                              int element_centroid) const;
+
+  /**
+   * @brief Gets a specific normal element.
+   *
+   * @param index_surface_element The index of the surface element.
+   * @param element_normal The index of the normal element. Valid values are
+   *               [0,dimension of the problem].
+   * @return The value of the specified normal element.
+   */
+  double get_normal_element(int index_surface_element,
+                            int element_normal) const;
+};
+
+#endif  // SURFACE_ELEMENTS_H
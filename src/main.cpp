@@ -1,10 +1,12 @@
 #include <chrono>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <sstream>
 
 #include "Cornelius.h"
+#include "CorneliusGrid.h"
 #include "cornelius_old.h"
 
 void cornelius_test_3D(int number_of_cubes_to_test, int number_of_tests,
@@ -239,6 +241,52 @@ void cornelius_test_4D(int number_of_cubes_to_test, int number_of_tests,
             << "\n";
 }
 
+void cornelius_grid_test(int number_of_threads) {
+  // Gaussian fireball which cools down with time on a 4D lattice
+  double grid_dt = 0.1;
+  double grid_dx = 0.2;
+  double T_cut = 0.16;
+  std::array<int, 4> number_points = {10, 64, 64, 64};
+  std::array<double, 4> dx_4D = {grid_dt, grid_dx, grid_dx, grid_dx};
+  const int n1 = number_points[1];
+  const int n2 = number_points[2];
+  const int n3 = number_points[3];
+  std::vector<double> field(number_points[0] * n1 * n2 * n3);
+  for (int i = 0; i < number_points[0]; i++) {
+    for (int j = 0; j < n1; j++) {
+      for (int k = 0; k < n2; k++) {
+        for (int l = 0; l < n3; l++) {
+          const double x = (j - 0.5 * n1) * grid_dx;
+          const double y = (k - 0.5 * n2) * grid_dx;
+          const double z = (l - 0.5 * n3) * grid_dx;
+          const double r2 = x * x + y * y + z * z;
+          field[((i * n1 + j) * n2 + k) * n3 + l] =
+              0.4 * std::exp(-0.5 * i * grid_dt) * std::exp(-r2 / 8.0);
+        }
+      }
+    }
+  }
+
+  std::unique_ptr<CorneliusGrid> grid_ptr(new CorneliusGrid());
+  grid_ptr->init_grid(4, T_cut, number_points, dx_4D);
+  grid_ptr->set_number_threads(number_of_threads);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  grid_ptr->find_surface(field.data());
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsed_seconds = end - start;
+
+  std::cout << "Elapsed time for CorneliusGrid with "
+            << grid_ptr->get_number_threads()
+            << " threads: " << elapsed_seconds.count() << "s ("
+            << grid_ptr->get_number_elements() << " elements)\n";
+  for (int t = 0; t < grid_ptr->get_number_threads(); t++) {
+    const CorneliusGrid::ThreadLoad& load = grid_ptr->get_thread_load(t);
+    std::cout << "  thread " << t << ": " << load.tiles << " tiles, "
+              << load.elements << " elements, " << load.seconds << "s\n";
+  }
+}
+
 int main(int argc, char const *argv[]) {
   int number_of_cubes_to_test =
       10;  // 10 is the maximum, since there are only 10 test files
@@ -252,5 +300,9 @@ int main(int argc, char const *argv[]) {
   cornelius_test_4D(number_of_cubes_to_test, number_of_tests,
                     print_intermediate_times);
 
+  // Lattice search with one thread and with all hardware threads
+  cornelius_grid_test(1);
+  cornelius_grid_test(0);
+
   return 0;
 }
@@ -44,6 +44,39 @@ TEST(CorneliusTest, throw_errors_out_of_range) {
   EXPECT_EQ(cornelius.get_number_elements(), 0);
 }
 
+TEST(CorneliusTest, component_views) {
+  Cornelius cornelius;
+  std::array<double, 4> dx = {0.1, 0.2, 0.2, 0.2};
+  cornelius.init_cornelius(4, 0.5, dx);
+  std::array<std::array<std::array<std::array<double, 2>, 2>, 2>, 2> cu;
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 2; j++) {
+      for (int k = 0; k < 2; k++) {
+        for (int l = 0; l < 2; l++) {
+          cu[i][j][k][l] = 0.2 * i + 0.3 * j + 0.15 * k + 0.1 * l;
+        }
+      }
+    }
+  }
+  cornelius.find_surface_4d(cu);
+  ASSERT_GT(cornelius.get_number_elements(), 0);
+
+  // The views give the same values as the tables
+  std::vector<std::vector<double>> normals = cornelius.get_normals();
+  std::vector<std::vector<double>> centroids = cornelius.get_centroids();
+  EXPECT_EQ(cornelius.get_elements().get_number_elements(),
+            cornelius.get_number_elements());
+  for (int j = 0; j < 4; j++) {
+    SurfaceElements::Span normal = cornelius.get_normal_component(j);
+    SurfaceElements::Span centroid = cornelius.get_centroid_component(j);
+    ASSERT_EQ(normal.size(), cornelius.get_number_elements());
+    for (int i = 0; i < cornelius.get_number_elements(); i++) {
+      EXPECT_EQ(normal[i], normals[i][j]);
+      EXPECT_EQ(centroid[i], centroids[i][j]);
+    }
+  }
+}
+
 TEST(CorneliusTest, apply_to_3D_surface) {
   const double tolerance = 1e-4;
   double grid_dt = 0.1;
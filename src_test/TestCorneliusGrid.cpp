@@ -0,0 +1,459 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "Cornelius.h"
+#include "CorneliusGrid.h"
+
+// Gaussian fireball with a slowly decaying maximum, sampled on the lattice
+std::vector<double> make_field(std::array<int, 4>& number_points,
+                               std::array<double, 4>& dx, int dimension) {
+  const int n0 = number_points[0];
+  const int n1 = number_points[1];
+  const int n2 = number_points[2];
+  const int n3 = (dimension == 4) ? number_points[3] : 1;
+  std::vector<double> field(n0 * n1 * n2 * n3);
+  for (int i = 0; i < n0; i++) {
+    for (int j = 0; j < n1; j++) {
+      for (int k = 0; k < n2; k++) {
+        for (int l = 0; l < n3; l++) {
+          const double tau = i * dx[0];
+          const double x = (j - 0.5 * (n1 - 1)) * dx[1];
+          const double y = (k - 0.5 * (n2 - 1)) * dx[2];
+          const double z = (dimension == 4) ? (l - 0.5 * (n3 - 1)) * dx[3] : 0;
+          const double r2 = x * x + 1.3 * y * y + 0.8 * z * z;
+          field[((i * n1 + j) * n2 + k) * n3 + l] =
+              0.3 * std::exp(-0.5 * tau) * std::exp(-r2 / 2.0);
+        }
+      }
+    }
+  }
+  return field;
+}
+
+// Goes through the cells by hand and compares the elements of the grid with
+// the ones of Cornelius element by element
+void expect_same_as_cornelius(CorneliusGrid& grid,
+                              const std::vector<double>& field,
+                              std::array<int, 4>& number_points,
+                              std::array<double, 4>& dx, int dimension,
+                              double value) {
+  Cornelius cornelius;
+  cornelius.init_cornelius(dimension, value, dx);
+  const int n1 = number_points[1];
+  const int n2 = number_points[2];
+  const int n3 = (dimension == 4) ? number_points[3] : 1;
+  // In 3D there is no last direction, one cell in it keeps the loops the same
+  const int cells_l = (dimension == 4) ? n3 - 1 : 1;
+  const int steps_l = (dimension == 4) ? 2 : 1;
+  int element = 0;
+  for (int i = 0; i < number_points[0] - 1; i++) {
+    for (int j = 0; j < n1 - 1; j++) {
+      for (int k = 0; k < n2 - 1; k++) {
+        for (int l = 0; l < cells_l; l++) {
+          std::array<std::array<std::array<std::array<double, 2>, 2>, 2>, 2>
+              cu;
+          for (int ci = 0; ci < 2; ci++) {
+            for (int cj = 0; cj < 2; cj++) {
+              for (int ck = 0; ck < 2; ck++) {
+                for (int cl = 0; cl < steps_l; cl++) {
+                  cu[ci][cj][ck][cl] =
+                      field[(((i + ci) * n1 + j + cj) * n2 + k + ck) * n3 + l +
+                            cl];
+                }
+              }
+            }
+          }
+          if (dimension == 3) {
+            std::array<std::array<std::array<double, 2>, 2>, 2> cu3;
+            for (int ci = 0; ci < 2; ci++) {
+              for (int cj = 0; cj < 2; cj++) {
+                for (int ck = 0; ck < 2; ck++) {
+                  cu3[ci][cj][ck] = cu[ci][cj][ck][0];
+                }
+              }
+            }
+            cornelius.find_surface_3d(cu3);
+          } else {
+            cornelius.find_surface_4d(cu);
+          }
+          std::array<int, 4> cell = {i, j, k, l};
+          for (int e = 0; e < cornelius.get_number_elements(); e++) {
+            ASSERT_LT(element, grid.get_number_elements());
+            for (int d = 0; d < dimension; d++) {
+              EXPECT_EQ(grid.get_cell_index(element, d), cell[d]);
+              EXPECT_EQ(grid.get_normal_element(element, d),
+                        cornelius.get_normal_element(e, d));
+              EXPECT_DOUBLE_EQ(grid.get_centroid_element(element, d),
+                               cornelius.get_centroid_element(e, d) +
+                                   cell[d] * dx[d]);
+            }
+            element++;
+          }
+        }
+      }
+    }
+  }
+  EXPECT_EQ(element, grid.get_number_elements());
+}
+
+TEST(CorneliusGridTest, uninitialized) {
+  CorneliusGrid grid;
+  EXPECT_EQ(grid.get_number_elements(), 0);
+  std::vector<double> field(16, 0.0);
+  EXPECT_EXIT(grid.find_surface(field.data()), ::testing::ExitedWithCode(1),
+              "CorneliusGrid not initialized.");
+}
+
+TEST(CorneliusGridTest, too_few_points) {
+  CorneliusGrid grid;
+  std::array<int, 4> number_points = {2, 1, 2, 0};
+  std::array<double, 4> dx = {1.0, 1.0, 1.0, 0.0};
+  EXPECT_EXIT(grid.init_grid(3, 0.5, number_points, dx),
+              ::testing::ExitedWithCode(1),
+              "CorneliusGrid needs at least two points in each direction.");
+  // The fourth entry is not used in 3D, but it is in 4D
+  number_points[1] = 2;
+  grid.init_grid(3, 0.5, number_points, dx);
+  EXPECT_EXIT(grid.init_grid(4, 0.5, number_points, dx),
+              ::testing::ExitedWithCode(1),
+              "CorneliusGrid needs at least two points in each direction.");
+}
+
+TEST(CorneliusGridTest, throw_errors_out_of_range) {
+  CorneliusGrid grid;
+  std::array<int, 4> number_points = {2, 2, 2, 0};
+  std::array<double, 4> dx = {1.0, 1.0, 1.0, 0.0};
+  grid.init_grid(3, 0.5, number_points, dx);
+  std::vector<double> field(8, 0.0);
+  grid.find_surface(field.data());
+
+  EXPECT_EQ(grid.get_number_elements(), 0);
+  EXPECT_THROW(grid.get_cell_index(0, 0), std::out_of_range);
+  EXPECT_THROW(grid.get_centroid_element(0, 0), std::out_of_range);
+  EXPECT_THROW(grid.get_normal_element(0, 0), std::out_of_range);
+}
+
+TEST(CorneliusGridTest, ambiguous_cell) {
+  // Two opposite corners above the value give two separate elements
+  CorneliusGrid grid;
+  std::array<int, 4> number_points = {2, 2, 2, 0};
+  std::array<double, 4> dx = {0.1, 0.1, 0.1, 0.0};
+  grid.init_grid(3, 0.5, number_points, dx);
+  std::vector<double> field = {1, 0, 0, 0, 0, 0, 0, 1};
+  grid.find_surface(field.data());
+
+  EXPECT_EQ(grid.get_number_elements(), 2);
+  // A 3D lattice has three components only
+  EXPECT_THROW(grid.get_cell_index(0, 3), std::out_of_range);
+  EXPECT_THROW(grid.get_normal_element(0, 3), std::out_of_range);
+}
+
+TEST(CorneliusGridTest, compare_to_single_cells_3D) {
+  std::array<int, 4> number_points = {12, 20, 18, 0};
+  std::array<double, 4> dx = {0.1, 0.2, 0.2, 0.0};
+  const double T_cut = 0.16;
+  std::vector<double> field = make_field(number_points, dx, 3);
+
+  CorneliusGrid grid;
+  grid.init_grid(3, T_cut, number_points, dx);
+  grid.find_surface(field.data());
+  ASSERT_GT(grid.get_number_elements(), 0);
+  expect_same_as_cornelius(grid, field, number_points, dx, 3, T_cut);
+}
+
+TEST(CorneliusGridTest, compare_to_single_cells_4D) {
+  std::array<int, 4> number_points = {5, 10, 9, 8};
+  std::array<double, 4> dx = {0.1, 0.4, 0.4, 0.4};
+  const double T_cut = 0.16;
+  std::vector<double> field = make_field(number_points, dx, 4);
+
+  CorneliusGrid grid;
+  grid.init_grid(4, T_cut, number_points, dx);
+  grid.find_surface(field.data());
+  ASSERT_GT(grid.get_number_elements(), 0);
+  expect_same_as_cornelius(grid, field, number_points, dx, 4, T_cut);
+}
+
+// Values below the surface everywhere except in a small box, so the surface
+// crosses only a few lines of cells of a few rows and the value ranges skip
+// everything else
+std::vector<double> make_step(std::array<int, 4>& number_points,
+                              int dimension, std::array<int, 4>& low,
+                              std::array<int, 4>& high) {
+  const int n3 = (dimension == 4) ? number_points[3] : 1;
+  std::vector<double> field;
+  for (int i = 0; i < number_points[0]; i++) {
+    for (int j = 0; j < number_points[1]; j++) {
+      for (int k = 0; k < number_points[2]; k++) {
+        for (int l = 0; l < n3; l++) {
+          const std::array<int, 4> point = {i, j, k, l};
+          bool inside = true;
+          for (int d = 0; d < dimension; d++) {
+            inside = inside && point[d] >= low[d] && point[d] <= high[d];
+          }
+          const double wiggle = 0.05 * std::sin(0.7 * field.size());
+          field.push_back((inside ? 0.8 : 0.2) + wiggle);
+        }
+      }
+    }
+  }
+  return field;
+}
+
+TEST(CorneliusGridTest, step_skips_rows_and_lines_3D) {
+  std::array<int, 4> number_points = {4, 9, 12, 0};
+  std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.0};
+  std::array<int, 4> low = {1, 4, 6, 0};
+  std::array<int, 4> high = {2, 5, 7, 0};
+  std::vector<double> field = make_step(number_points, 3, low, high);
+
+  CorneliusGrid grid;
+  grid.init_grid(3, 0.5, number_points, dx);
+  grid.find_surface(field.data());
+  ASSERT_GT(grid.get_number_elements(), 0);
+  expect_same_as_cornelius(grid, field, number_points, dx, 3, 0.5);
+}
+
+TEST(CorneliusGridTest, step_skips_rows_and_lines_4D) {
+  // The box touches only the lines k = 3 and k = 4 of the planes j = 2 and
+  // j = 3, so most lines of the crossed rows are skipped as well
+  std::array<int, 4> number_points = {4, 6, 8, 9};
+  std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.4};
+  std::array<int, 4> low = {1, 2, 3, 4};
+  std::array<int, 4> high = {2, 3, 4, 5};
+  std::vector<double> field = make_step(number_points, 4, low, high);
+
+  CorneliusGrid grid;
+  grid.init_grid(4, 0.5, number_points, dx);
+  grid.find_surface(field.data());
+  ASSERT_GT(grid.get_number_elements(), 0);
+  expect_same_as_cornelius(grid, field, number_points, dx, 4, 0.5);
+}
+
+TEST(CorneliusGridTest, checkerboard_4D) {
+  // Every other corner above the value, so all faces of all cells are
+  // ambiguous
+  std::array<int, 4> number_points = {3, 4, 4, 5};
+  std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.4};
+  std::vector<double> field;
+  for (int i = 0; i < number_points[0]; i++) {
+    for (int j = 0; j < number_points[1]; j++) {
+      for (int k = 0; k < number_points[2]; k++) {
+        for (int l = 0; l < number_points[3]; l++) {
+          const double step = ((i + j + k + l) % 2 == 0) ? 0.3 : -0.3;
+          field.push_back(0.5 + step * (1.0 + 0.2 * std::sin(field.size())));
+        }
+      }
+    }
+  }
+
+  CorneliusGrid grid;
+  grid.init_grid(4, 0.5, number_points, dx);
+  grid.find_surface(field.data());
+  ASSERT_GT(grid.get_number_elements(), 0);
+  expect_same_as_cornelius(grid, field, number_points, dx, 4, 0.5);
+}
+
+// Values on three levels, one of them exactly the value of the surface, on
+// lines of points longer than one word of sign bits
+std::vector<double> make_levels(std::array<int, 4>& number_points,
+                                int dimension) {
+  const std::array<double, 3> levels = {0.3, 0.5, 0.7};
+  std::size_t size = 1;
+  for (int d = 0; d < dimension; d++) {
+    size *= number_points[d];
+  }
+  std::vector<double> field(size);
+  for (std::size_t p = 0; p < size; p++) {
+    field[p] = levels[(p * p + 3 * p) % 7 % 3];
+  }
+  return field;
+}
+
+TEST(CorneliusGridTest, long_lines_3D) {
+  // 64 * k + 1 points give cells up to the last bit of a word, whose upper
+  // corner is in the next word
+  for (int line_size : {65, 100, 129}) {
+    std::array<int, 4> number_points = {3, 4, line_size, 0};
+    std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.0};
+    std::vector<double> field = make_levels(number_points, 3);
+
+    CorneliusGrid grid;
+    grid.init_grid(3, 0.5, number_points, dx);
+    grid.find_surface(field.data());
+    ASSERT_GT(grid.get_number_elements(), 0);
+    expect_same_as_cornelius(grid, field, number_points, dx, 3, 0.5);
+  }
+}
+
+TEST(CorneliusGridTest, long_lines_4D) {
+  for (int line_size : {65, 100, 129}) {
+    std::array<int, 4> number_points = {2, 3, 3, line_size};
+    std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.4};
+    std::vector<double> field = make_levels(number_points, 4);
+
+    CorneliusGrid grid;
+    grid.init_grid(4, 0.5, number_points, dx);
+    grid.find_surface(field.data());
+    ASSERT_GT(grid.get_number_elements(), 0);
+    expect_same_as_cornelius(grid, field, number_points, dx, 4, 0.5);
+  }
+}
+
+TEST(CorneliusGridTest, single_points_at_word_ends) {
+  // Single points above or exactly at the value at both sides of the word
+  // boundaries, with the last point of the line in a word of its own
+  for (int dimension : {3, 4}) {
+    const int line_size = 129;
+    std::array<int, 4> number_points = {2, 3, line_size, 0};
+    if (dimension == 4) {
+      number_points = {2, 3, 2, line_size};
+    }
+    std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.4};
+    const std::size_t number_lines = (dimension == 4) ? 2 * 3 * 2 : 2 * 3;
+    std::vector<double> field(number_lines * line_size, 0.2);
+    const std::array<int, 5> points = {63, 64, 127, 128, 0};
+    for (std::size_t line = 0; line < number_lines; line++) {
+      field[line * line_size + points[line % points.size()]] =
+          (line % 2 == 0) ? 0.8 : 0.5;
+    }
+
+    CorneliusGrid grid;
+    grid.init_grid(dimension, 0.5, number_points, dx);
+    grid.find_surface(field.data());
+    ASSERT_GT(grid.get_number_elements(), 0);
+    expect_same_as_cornelius(grid, field, number_points, dx, dimension, 0.5);
+  }
+}
+
+TEST(CorneliusGridTest, independent_of_number_threads) {
+  std::array<int, 4> number_points = {6, 12, 11, 10};
+  std::array<double, 4> dx = {0.1, 0.3, 0.3, 0.3};
+  const double T_cut = 0.16;
+  std::vector<double> field = make_field(number_points, dx, 4);
+
+  CorneliusGrid grid_serial;
+  grid_serial.init_grid(4, T_cut, number_points, dx);
+  grid_serial.find_surface(field.data());
+  ASSERT_GT(grid_serial.get_number_elements(), 0);
+
+  for (int threads : {2, 3, 8, 64}) {
+    CorneliusGrid grid;
+    grid.init_grid(4, T_cut, number_points, dx);
+    grid.set_number_threads(threads);
+    EXPECT_EQ(grid.get_number_threads(), threads);
+    grid.find_surface(field.data());
+    ASSERT_EQ(grid.get_number_elements(), grid_serial.get_number_elements());
+    for (int e = 0; e < grid.get_number_elements(); e++) {
+      for (int d = 0; d < 4; d++) {
+        EXPECT_EQ(grid.get_cell_index(e, d), grid_serial.get_cell_index(e, d));
+        EXPECT_EQ(grid.get_centroid_element(e, d),
+                  grid_serial.get_centroid_element(e, d));
+        EXPECT_EQ(grid.get_normal_element(e, d),
+                  grid_serial.get_normal_element(e, d));
+      }
+    }
+  }
+}
+
+TEST(CorneliusGridTest, repeated_searches_reuse_threads) {
+  std::array<int, 4> number_points = {4, 9, 8, 7};
+  std::array<double, 4> dx = {0.1, 0.4, 0.4, 0.4};
+  const double T_cut = 0.16;
+  std::vector<double> field = make_field(number_points, dx, 4);
+
+  CorneliusGrid grid_serial;
+  grid_serial.init_grid(4, T_cut, number_points, dx);
+  grid_serial.find_surface(field.data());
+  ASSERT_GT(grid_serial.get_number_elements(), 0);
+
+  // The worker threads are kept from search to search, also when the
+  // number of threads changes in between
+  CorneliusGrid grid;
+  grid.init_grid(4, T_cut, number_points, dx);
+  for (int threads : {4, 2, 5, 1, 3}) {
+    grid.set_number_threads(threads);
+    for (int repeat = 0; repeat < 20; repeat++) {
+      grid.find_surface(field.data());
+      ASSERT_EQ(grid.get_number_elements(),
+                grid_serial.get_number_elements());
+    }
+    for (int e = 0; e < grid.get_number_elements(); e++) {
+      for (int d = 0; d < 4; d++) {
+        EXPECT_EQ(grid.get_centroid_element(e, d),
+                  grid_serial.get_centroid_element(e, d));
+      }
+    }
+  }
+}
+
+TEST(CorneliusGridTest, append_slabs_reuses_time_faces) {
+  std::array<int, 4> number_points = {7, 11, 10, 9};
+  std::array<double, 4> dx = {0.1, 0.3, 0.3, 0.3};
+  const double T_cut = 0.16;
+  std::vector<double> field = make_field(number_points, dx, 4);
+  const std::size_t slice_size =
+      number_points[1] * number_points[2] * number_points[3];
+
+  CorneliusGrid grid_full;
+  grid_full.init_grid(4, T_cut, number_points, dx);
+  grid_full.find_surface(field.data());
+  ASSERT_GT(grid_full.get_number_elements(), 0);
+
+  // The polygons on the time faces are handed from slab to slab, also
+  // between threads, and the results must not change
+  for (int threads : {1, 3}) {
+    CorneliusGrid grid;
+    grid.init_grid(4, T_cut, number_points, dx);
+    grid.set_number_threads(threads);
+    for (int i = 0; i < number_points[0] - 1; i++) {
+      grid.append_slab(field.data() + i * slice_size,
+                       field.data() + (i + 1) * slice_size, i, i * dx[0],
+                       dx[0]);
+    }
+    ASSERT_EQ(grid.get_number_elements(), grid_full.get_number_elements());
+    for (int e = 0; e < grid.get_number_elements(); e++) {
+      for (int d = 0; d < 4; d++) {
+        EXPECT_EQ(grid.get_cell_index(e, d), grid_full.get_cell_index(e, d));
+        EXPECT_EQ(grid.get_centroid_element(e, d),
+                  grid_full.get_centroid_element(e, d));
+        EXPECT_EQ(grid.get_normal_element(e, d),
+                  grid_full.get_normal_element(e, d));
+      }
+    }
+  }
+}
+
+TEST(CorneliusGridTest, thread_load) {
+  std::array<int, 4> number_points = {4, 9, 8, 7};
+  std::array<double, 4> dx = {0.1, 0.4, 0.4, 0.4};
+  std::vector<double> field = make_field(number_points, dx, 4);
+
+  CorneliusGrid grid;
+  grid.init_grid(4, 0.16, number_points, dx);
+  grid.set_number_threads(4);
+  EXPECT_THROW(grid.get_thread_load(4), std::out_of_range);
+  grid.find_surface(field.data());
+
+  // Every tile and cell is searched exactly once
+  int tiles = 0;
+  long cells = 0;
+  long elements = 0;
+  for (int t = 0; t < grid.get_number_threads(); t++) {
+    const CorneliusGrid::ThreadLoad& load = grid.get_thread_load(t);
+    tiles += load.tiles;
+    cells += load.cells;
+    elements += load.elements;
+    EXPECT_GE(load.seconds, 0.0);
+  }
+  EXPECT_EQ(tiles, 3 * 8);
+  EXPECT_EQ(cells, 3 * 8 * 7 * 6);
+  EXPECT_EQ(elements, grid.get_number_elements());
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
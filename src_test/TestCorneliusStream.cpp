@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "CorneliusGrid.h"
+#include "CorneliusStream.h"
+
+// Gaussian fireball which cools down with time, one spatial slice
+std::vector<double> make_slice(double tau, std::array<int, 3>& number_points,
+                               std::array<double, 3>& dx) {
+  const int n1 = number_points[0];
+  const int n2 = number_points[1];
+  const int n3 = number_points[2];
+  std::vector<double> slice(n1 * n2 * n3);
+  for (int j = 0; j < n1; j++) {
+    for (int k = 0; k < n2; k++) {
+      for (int l = 0; l < n3; l++) {
+        const double x = (j - 0.5 * (n1 - 1)) * dx[0];
+        const double y = (k - 0.5 * (n2 - 1)) * dx[1];
+        const double z = (l - 0.5 * (n3 - 1)) * dx[2];
+        const double r2 = x * x + 1.3 * y * y + 0.8 * z * z;
+        slice[(j * n2 + k) * n3 + l] =
+            0.3 * std::exp(-0.5 * tau) * std::exp(-r2 / 2.0);
+      }
+    }
+  }
+  return slice;
+}
+
+TEST(CorneliusStreamTest, uninitialized) {
+  CorneliusStream stream;
+  EXPECT_EQ(stream.get_number_slices(), 0);
+  std::vector<double> field(8, 0.0);
+  EXPECT_EXIT(stream.push_slice(0.0, field.data()),
+              ::testing::ExitedWithCode(1), "CorneliusStream not initialized.");
+}
+
+TEST(CorneliusStreamTest, time_must_increase) {
+  std::array<int, 3> number_points = {4, 4, 4};
+  std::array<double, 3> dx = {0.5, 0.5, 0.5};
+  std::vector<double> slice(64, 0.0);
+  CorneliusStream stream;
+  stream.init_stream(0.16, number_points, dx);
+  stream.push_slice(1.0, slice.data());
+  EXPECT_EXIT(stream.push_slice(1.0, slice.data()),
+              ::testing::ExitedWithCode(1),
+              "the time of a slice must be larger");
+  EXPECT_EXIT(stream.push_slice(0.9, slice.data()),
+              ::testing::ExitedWithCode(1),
+              "the time of a slice must be larger");
+  stream.push_slice(1.1, slice.data());
+  EXPECT_EQ(stream.get_number_slices(), 2);
+}
+
+TEST(CorneliusStreamTest, compare_to_grid) {
+  std::array<int, 3> number_points = {10, 9, 8};
+  std::array<double, 3> dx = {0.4, 0.4, 0.4};
+  const double dt = 0.1;
+  const int number_steps = 6;
+  const double T_cut = 0.16;
+
+  // Full field for the lattice engine
+  std::vector<double> field;
+  for (int i = 0; i < number_steps; i++) {
+    std::vector<double> slice = make_slice(i * dt, number_points, dx);
+    field.insert(field.end(), slice.begin(), slice.end());
+  }
+  CorneliusGrid grid;
+  std::array<int, 4> grid_points = {number_steps, number_points[0],
+                                    number_points[1], number_points[2]};
+  std::array<double, 4> grid_dx = {dt, dx[0], dx[1], dx[2]};
+  grid.init_grid(4, T_cut, grid_points, grid_dx);
+  grid.find_surface(field.data());
+  ASSERT_GT(grid.get_number_elements(), 0);
+
+  CorneliusStream stream;
+  stream.init_stream(T_cut, number_points, dx);
+  int element = 0;
+  for (int i = 0; i < number_steps; i++) {
+    std::vector<double> slice = make_slice(i * dt, number_points, dx);
+    stream.push_slice(i * dt, slice.data());
+    // The buffer of the caller may be overwritten after the push
+    std::fill(slice.begin(), slice.end(), 0.0);
+    EXPECT_EQ(stream.get_number_slices(), i + 1);
+    if (i == 0) {
+      EXPECT_EQ(stream.get_number_elements(), 0);
+    }
+    for (int e = 0; e < stream.get_number_elements(); e++) {
+      ASSERT_LT(element, grid.get_number_elements());
+      for (int d = 0; d < 4; d++) {
+        EXPECT_EQ(stream.get_cell_index(e, d), grid.get_cell_index(element, d));
+        EXPECT_NEAR(stream.get_centroid_element(e, d),
+                    grid.get_centroid_element(element, d), 1e-12);
+        EXPECT_NEAR(stream.get_normal_element(e, d),
+                    grid.get_normal_element(element, d), 1e-12);
+      }
+      element++;
+    }
+  }
+  EXPECT_EQ(element, grid.get_number_elements());
+}
+
+TEST(CorneliusStreamTest, variable_time_step) {
+  std::array<int, 3> number_points = {8, 8, 8};
+  std::array<double, 3> dx = {0.5, 0.5, 0.5};
+  const double T_cut = 0.16;
+  std::array<double, 3> taus = {0.6, 0.75, 1.05};
+
+  CorneliusStream stream;
+  stream.init_stream(T_cut, number_points, dx);
+  for (int i = 0; i < 3; i++) {
+    std::vector<double> slice = make_slice(taus[i], number_points, dx);
+    stream.push_slice(taus[i], slice.data());
+    if (i == 0) {
+      continue;
+    }
+    // Every element must lie inside the time step
+    ASSERT_GT(stream.get_number_elements(), 0);
+    for (int e = 0; e < stream.get_number_elements(); e++) {
+      EXPECT_EQ(stream.get_cell_index(e, 0), i - 1);
+      EXPECT_GE(stream.get_centroid_element(e, 0), taus[i - 1]);
+      EXPECT_LE(stream.get_centroid_element(e, 0), taus[i]);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,99 @@ TEST(CubeTest, init_cube) {
   EXPECT_FALSE(cube.is_ambiguous());
 }
 
+TEST(CubeTest, all_corner_patterns) {
+  // Every pattern of corners above the value gives closed polygons
+  std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.4};
+  for (int pattern = 1; pattern < 255; pattern++) {
+    std::array<std::array<std::array<double, 2>, 2>, 2> cu;
+    for (int c = 0; c < 8; c++) {
+      cu[c >> 2][(c >> 1) & 1][c & 1] =
+          ((pattern >> c) & 1) ? 0.7 + 0.01 * c : 0.3 - 0.01 * c;
+    }
+    Cube cube;
+    cube.init_cube(cu, 0, 0.0, dx);
+    cube.construct_polygons(0.5);
+    ASSERT_GT(cube.get_number_polygons(), 0);
+    int number_lines = 0;
+    for (int p = 0; p < cube.get_number_polygons(); p++) {
+      Polygon& polygon = cube.get_polygons()[p];
+      number_lines += polygon.get_number_lines();
+      // Each end point is the start point of another line
+      for (int i = 0; i < polygon.get_number_lines(); i++) {
+        auto& end_point = polygon.get_line(i).get_end_point();
+        int connected = 0;
+        for (int j = 0; j < polygon.get_number_lines(); j++) {
+          auto& start_point = polygon.get_line(j).get_start_point();
+          auto& other_end_point = polygon.get_line(j).get_end_point();
+          if ((i != j) && (start_point == end_point ||
+                           other_end_point == end_point)) {
+            connected++;
+          }
+        }
+        EXPECT_EQ(connected, 1);
+      }
+    }
+    EXPECT_EQ(number_lines, cube.get_number_lines());
+  }
+}
+
+TEST(CubeTest, given_squares) {
+  // Squares with the constant indices in the other order, as they come from
+  // a neighbouring cube in a hypercube, give the same polygons
+  std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.4};
+  const std::array<double, 8> values = {0.7, 0.3, 0.2, 0.8,
+                                        0.4, 0.9, 0.6, 0.1};
+  std::array<std::array<std::array<double, 2>, 2>, 2> cu;
+  for (int c = 0; c < 8; c++) {
+    cu[c >> 2][(c >> 1) & 1][c & 1] = values[c];
+  }
+  Cube cube;
+  cube.init_cube(cu, 1, dx[1], dx);
+  cube.construct_polygons(0.5);
+  ASSERT_TRUE(cube.is_ambiguous());
+
+  // Squares of the cube with the directions 0, 2, 3 at x1 = dx[1]
+  std::array<Square, 6> squares;
+  std::array<Square*, 6> square_refs;
+  const std::array<int, 3> x = {0, 2, 3};
+  for (int s = 0; s < 6; s++) {
+    const int fixed = s / 2;
+    const int j = s % 2;
+    std::array<std::array<double, 2>, 2> sq;
+    for (int a = 0; a < 2; a++) {
+      for (int b = 0; b < 2; b++) {
+        sq[a][b] = (fixed == 0)   ? cu[j][a][b]
+                   : (fixed == 1) ? cu[a][j][b]
+                                  : cu[a][b][j];
+      }
+    }
+    std::array<int, 2> c_i = {x[fixed], 1};
+    std::array<double, 2> c_v = {j * dx[x[fixed]], dx[1]};
+    squares[s].init_square(sq, c_i, c_v, dx);
+    squares[s].construct_lines(0.5);
+    square_refs[s] = &squares[s];
+  }
+  Cube shared;
+  shared.init_cube(cu, 1, dx[1], dx);
+  shared.set_squares(&square_refs);
+  shared.construct_polygons(0.5);
+  ASSERT_EQ(shared.get_number_polygons(), cube.get_number_polygons());
+  for (int p = 0; p < cube.get_number_polygons(); p++) {
+    Polygon& polygon = cube.get_polygons()[p];
+    Polygon& shared_polygon = shared.get_polygons()[p];
+    ASSERT_EQ(shared_polygon.get_number_lines(), polygon.get_number_lines());
+    for (int i = 0; i < polygon.get_number_lines(); i++) {
+      EXPECT_EQ(shared_polygon.get_line(i).get_start_point(),
+                polygon.get_line(i).get_start_point());
+      EXPECT_EQ(shared_polygon.get_line(i).get_end_point(),
+                polygon.get_line(i).get_end_point());
+      EXPECT_EQ(shared_polygon.get_line(i).get_outside_point(),
+                polygon.get_line(i).get_outside_point());
+    }
+    EXPECT_EQ(shared_polygon.get_centroid(), polygon.get_centroid());
+  }
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "Cornelius.h"
+#include "CubeBatch.h"
+#include "Square.h"
+
+// Cuts of the 12 edges of a cell, numbered as in Cube
+std::array<double, 12> cell_cuts(
+    const std::array<std::array<std::array<double, 2>, 2>, 2>& cu,
+    double value, const std::array<double, 4>& dx) {
+  std::array<double, 12> cuts;
+  for (int edge = 0; edge < 12; edge++) {
+    const int direction = edge / 4;
+    const int low = Cube::edge_corner(edge);
+    const int high = low | (1 << (2 - direction));
+    cuts[edge] = Square::edge_cut(cu[low >> 2][(low >> 1) & 1][low & 1],
+                                  cu[high >> 2][(high >> 1) & 1][high & 1],
+                                  value, dx[direction]);
+  }
+  return cuts;
+}
+
+TEST(CubeBatchTest, same_as_cornelius) {
+  // Several cells of every pattern, some with corners exactly at the value,
+  // give the same elements as Cornelius bit by bit
+  const double value = 0.5;
+  std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.0};
+  std::mt19937 generator(12345);
+  std::uniform_real_distribution<double> above(0.5, 1.0);
+  std::uniform_real_distribution<double> below(0.0, 0.5);
+  std::vector<std::array<std::array<std::array<double, 2>, 2>, 2>> cells;
+  std::vector<int> indices;
+  CubeBatch batch;
+  batch.init_batch(dx);
+  for (int trial = 0; trial < 20; trial++) {
+    for (int pattern = 1; pattern < 255; pattern++) {
+      std::array<std::array<std::array<double, 2>, 2>, 2> cu;
+      for (int c = 0; c < 8; c++) {
+        double corner = ((pattern >> c) & 1) ? above(generator)
+                                              : below(generator);
+        if (trial % 4 == 0 && corner >= value && c % 3 == 0) {
+          corner = value;
+        }
+        cu[c >> 2][(c >> 1) & 1][c & 1] = corner;
+      }
+      const int index = batch.add_cell(pattern, cell_cuts(cu, value, dx));
+      if (Cube::get_case(pattern).ambiguous) {
+        EXPECT_EQ(index, -1);
+      }
+      if (index >= 0) {
+        cells.push_back(cu);
+        indices.push_back(index);
+      }
+    }
+  }
+  ASSERT_GT(batch.get_number_cells(), 0);
+  batch.find_elements();
+
+  Cornelius cornelius;
+  cornelius.init_cornelius(3, value, dx);
+  for (std::size_t i = 0; i < cells.size(); i++) {
+    cornelius.find_surface_3d(cells[i]);
+    ASSERT_EQ(cornelius.get_number_elements(), 1);
+    for (int j = 0; j < 3; j++) {
+      EXPECT_EQ(batch.get_normal_element(indices[i], j),
+                cornelius.get_normal_element(0, j));
+      EXPECT_EQ(batch.get_centroid_element(indices[i], j),
+                cornelius.get_centroid_element(0, j));
+    }
+  }
+}
+
+TEST(CubeBatchTest, cells_not_taken) {
+  std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.0};
+  CubeBatch batch;
+  batch.init_batch(dx);
+  std::array<double, 12> cuts;
+  cuts.fill(0.05);
+  // No surface or ambiguous faces
+  EXPECT_EQ(batch.add_cell(0, cuts), -1);
+  EXPECT_EQ(batch.add_cell(255, cuts), -1);
+  ASSERT_TRUE(Cube::get_case(9).ambiguous);
+  EXPECT_EQ(batch.add_cell(9, cuts), -1);
+  // A cut which does not match the pattern
+  std::array<double, 12> missing = cuts;
+  missing.fill(std::nan(""));
+  EXPECT_EQ(batch.add_cell(1, missing), -1);
+  EXPECT_EQ(batch.get_number_cells(), 0);
+
+  EXPECT_EQ(batch.add_cell(1, cuts), 0);
+  batch.find_elements();
+  EXPECT_THROW(batch.get_normal_element(1, 0), std::out_of_range);
+  EXPECT_THROW(batch.get_centroid_element(0, 3), std::out_of_range);
+  batch.clear();
+  EXPECT_EQ(batch.get_number_cells(), 0);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include "FixedVector.h"
+
+TEST(FixedVectorTest, Constructor) {
+  FixedVector<int, 4> vector;
+  EXPECT_EQ(vector.size(), 0);
+  EXPECT_TRUE(vector.empty());
+  EXPECT_EQ(vector.capacity(), 4);
+}
+
+TEST(FixedVectorTest, push_back_and_clear) {
+  FixedVector<int, 4> vector;
+  for (int i = 0; i < 4; i++) {
+    vector.push_back(10 * i);
+  }
+  EXPECT_EQ(vector.size(), 4);
+  EXPECT_EQ(vector.back(), 30);
+  int sum = 0;
+  for (int value : vector) {
+    sum += value;
+  }
+  EXPECT_EQ(sum, 60);
+
+  // The elements are kept and handed out again by push_slot()
+  vector.clear();
+  EXPECT_TRUE(vector.empty());
+  EXPECT_EQ(vector.push_slot(), 0);
+  EXPECT_EQ(vector.push_slot(), 10);
+  EXPECT_EQ(vector.size(), 2);
+}
+
+TEST(FixedVectorTest, capacity_exceeded) {
+  FixedVector<int, 2> vector;
+  vector.push_back(1);
+  vector.push_back(2);
+  EXPECT_EXIT(vector.push_back(3), ::testing::ExitedWithCode(1),
+              "FixedVector error: capacity of 2 exceeded.");
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
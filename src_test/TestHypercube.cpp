@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "Hypercube.h"
 
 TEST(HypercubeTest, init_hypercube) {
@@ -23,6 +25,72 @@ TEST(HypercubeTest, init_hypercube) {
   EXPECT_FALSE(hypercube.is_ambiguous());
 }
 
+TEST(HypercubeTest, ambiguous_hypercube) {
+  // Two opposite corners above the value give two separate polyhedra
+  std::array<std::array<std::array<std::array<double, 2>, 2>, 2>, 2> hc = {};
+  hc[0][0][0][0] = 1;
+  hc[1][1][1][1] = 1;
+  std::array<double, 4> dx = {0.1, 0.1, 0.1, 0.1};
+  Hypercube hypercube;
+  hypercube.init_hypercube(hc, dx);
+  hypercube.construct_polyhedra(0.5);
+
+  EXPECT_TRUE(hypercube.is_ambiguous());
+  ASSERT_EQ(hypercube.get_number_polyhedra(), 2);
+  for (int i = 0; i < 2; i++) {
+    // Each corner is cut off by one tetrahedron with four triangular faces
+    Polyhedron& polyhedron = hypercube.get_polyhedra()[i];
+    EXPECT_EQ(polyhedron.get_number_tetrahedrons(), 12);
+  }
+}
+
+TEST(HypercubeTest, all_corner_patterns) {
+  // Each line of a square belongs to the polygons of two cubes, so the number
+  // of tetrahedra is twice the number of lines in the 24 squares
+  std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.4};
+  Hypercube hypercube;
+  for (int pattern = 1; pattern < 65535; pattern++) {
+    std::array<std::array<std::array<std::array<double, 2>, 2>, 2>, 2> hc;
+    for (int h = 0; h < 16; h++) {
+      hc[h >> 3][(h >> 2) & 1][(h >> 1) & 1][h & 1] =
+          ((pattern >> h) & 1) ? 0.7 + 0.01 * h : 0.3 - 0.01 * h;
+    }
+    int square_lines = 0;
+    for (int d1 = 0; d1 < 4; d1++) {
+      for (int d2 = d1 + 1; d2 < 4; d2++) {
+        for (int h = 0; h < 16; h++) {
+          // h is the lower corner of the square in the directions d1 and d2
+          if ((h >> (3 - d1)) & 1 || (h >> (3 - d2)) & 1) {
+            continue;
+          }
+          const int h1 = h | (1 << (3 - d1));
+          const int h2 = h | (1 << (3 - d2));
+          const int h12 = h1 | h2;
+          int cuts = 0;
+          cuts += ((pattern >> h) & 1) != ((pattern >> h1) & 1);
+          cuts += ((pattern >> h) & 1) != ((pattern >> h2) & 1);
+          cuts += ((pattern >> h1) & 1) != ((pattern >> h12) & 1);
+          cuts += ((pattern >> h2) & 1) != ((pattern >> h12) & 1);
+          square_lines += cuts / 2;
+        }
+      }
+    }
+
+    hypercube.init_hypercube(hc, dx);
+    hypercube.construct_polyhedra(0.5);
+    ASSERT_GT(hypercube.get_number_polyhedra(), 0);
+    int number_tetrahedrons = 0;
+    for (int i = 0; i < hypercube.get_number_polyhedra(); i++) {
+      Polyhedron& polyhedron = hypercube.get_polyhedra()[i];
+      number_tetrahedrons += polyhedron.get_number_tetrahedrons();
+      for (double component : polyhedron.get_normal()) {
+        EXPECT_TRUE(std::isfinite(component));
+      }
+    }
+    EXPECT_EQ(number_tetrahedrons, 2 * square_lines) << "pattern " << pattern;
+  }
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -136,6 +136,32 @@ TEST(PolygonTest, calculate_normal) {
   ASSERT_EQ(polygon.get_normal()[3], 0.5);
 }
 
+TEST(PolygonTest, normal_with_given_centroid) {
+  // The normal found together with the centroid agrees with the one found
+  // from a given centroid up to rounding
+  std::array<std::array<double, 4>, 4> points = {
+      {{0, 0, 0, 0}, {0, 1, 0, 0.2}, {0, 1, 1, 0.1}, {0, 0, 1.5, 0}}};
+  std::array<double, 4> out = {0, -1, -1, -1};
+  std::array<int, 2> const_i = {0, 1};
+  std::array<Line, 4> lines;
+  Polygon polygon;
+  Polygon polygon_given;
+  polygon.init_polygon(0);
+  polygon_given.init_polygon(0);
+  for (int i = 0; i < 4; i++) {
+    lines[i].init_line({points[i], points[(i + 1) % 4]}, out, const_i);
+    polygon.add_line(lines[i], true);
+    polygon_given.add_line(lines[i], true);
+  }
+  polygon_given.set_centroid(polygon.get_centroid());
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_NEAR(polygon.get_normal()[i], polygon_given.get_normal()[i],
+                1e-14);
+  }
+  EXPECT_GT(std::abs(polygon.get_normal()[1]), 0.1);
+}
+
 TEST(PolygonTest, get_lines) {
   Polygon polygon;
 
@@ -165,50 +191,50 @@ TEST(PolygonTest, get_lines) {
 
   auto lines = polygon.get_lines();
 
-  ASSERT_EQ(lines[0].get_start_point()[0], 0);
-  ASSERT_EQ(lines[0].get_start_point()[1], 0);
-  ASSERT_EQ(lines[0].get_start_point()[2], 0);
-  ASSERT_EQ(lines[0].get_start_point()[3], 0);
-
-  ASSERT_EQ(lines[0].get_end_point()[0], 1);
-  ASSERT_EQ(lines[0].get_end_point()[1], 1);
-  ASSERT_EQ(lines[0].get_end_point()[2], 1);
-  ASSERT_EQ(lines[0].get_end_point()[3], 1);
-
-  ASSERT_EQ(lines[0].get_outside_point()[0], 2);
-  ASSERT_EQ(lines[0].get_outside_point()[1], 1);
-  ASSERT_EQ(lines[0].get_outside_point()[2], 1);
-  ASSERT_EQ(lines[0].get_outside_point()[3], 1);
-
-  ASSERT_EQ(lines[1].get_start_point()[0], 1);
-  ASSERT_EQ(lines[1].get_start_point()[1], 1);
-  ASSERT_EQ(lines[1].get_start_point()[2], 1);
-  ASSERT_EQ(lines[1].get_start_point()[3], 1);
-
-  ASSERT_EQ(lines[1].get_end_point()[0], 2);
-  ASSERT_EQ(lines[1].get_end_point()[1], 2);
-  ASSERT_EQ(lines[1].get_end_point()[2], 2);
-  ASSERT_EQ(lines[1].get_end_point()[3], 2);
-
-  ASSERT_EQ(lines[1].get_outside_point()[0], 2);
-  ASSERT_EQ(lines[1].get_outside_point()[1], 1);
-  ASSERT_EQ(lines[1].get_outside_point()[2], 1);
-  ASSERT_EQ(lines[1].get_outside_point()[3], 1);
-
-  ASSERT_EQ(lines[2].get_start_point()[0], 2);
-  ASSERT_EQ(lines[2].get_start_point()[1], 2);
-  ASSERT_EQ(lines[2].get_start_point()[2], 2);
-  ASSERT_EQ(lines[2].get_start_point()[3], 2);
-
-  ASSERT_EQ(lines[2].get_end_point()[0], 3);
-  ASSERT_EQ(lines[2].get_end_point()[1], 2);
-  ASSERT_EQ(lines[2].get_end_point()[2], 3);
-  ASSERT_EQ(lines[2].get_end_point()[3], 3);
-
-  ASSERT_EQ(lines[2].get_outside_point()[0], 2);
-  ASSERT_EQ(lines[2].get_outside_point()[1], 1);
-  ASSERT_EQ(lines[2].get_outside_point()[2], 1);
-  ASSERT_EQ(lines[2].get_outside_point()[3], 1);
+  ASSERT_EQ(lines[0]->get_start_point()[0], 0);
+  ASSERT_EQ(lines[0]->get_start_point()[1], 0);
+  ASSERT_EQ(lines[0]->get_start_point()[2], 0);
+  ASSERT_EQ(lines[0]->get_start_point()[3], 0);
+
+  ASSERT_EQ(lines[0]->get_end_point()[0], 1);
+  ASSERT_EQ(lines[0]->get_end_point()[1], 1);
+  ASSERT_EQ(lines[0]->get_end_point()[2], 1);
+  ASSERT_EQ(lines[0]->get_end_point()[3], 1);
+
+  ASSERT_EQ(lines[0]->get_outside_point()[0], 2);
+  ASSERT_EQ(lines[0]->get_outside_point()[1], 1);
+  ASSERT_EQ(lines[0]->get_outside_point()[2], 1);
+  ASSERT_EQ(lines[0]->get_outside_point()[3], 1);
+
+  ASSERT_EQ(lines[1]->get_start_point()[0], 1);
+  ASSERT_EQ(lines[1]->get_start_point()[1], 1);
+  ASSERT_EQ(lines[1]->get_start_point()[2], 1);
+  ASSERT_EQ(lines[1]->get_start_point()[3], 1);
+
+  ASSERT_EQ(lines[1]->get_end_point()[0], 2);
+  ASSERT_EQ(lines[1]->get_end_point()[1], 2);
+  ASSERT_EQ(lines[1]->get_end_point()[2], 2);
+  ASSERT_EQ(lines[1]->get_end_point()[3], 2);
+
+  ASSERT_EQ(lines[1]->get_outside_point()[0], 2);
+  ASSERT_EQ(lines[1]->get_outside_point()[1], 1);
+  ASSERT_EQ(lines[1]->get_outside_point()[2], 1);
+  ASSERT_EQ(lines[1]->get_outside_point()[3], 1);
+
+  ASSERT_EQ(lines[2]->get_start_point()[0], 2);
+  ASSERT_EQ(lines[2]->get_start_point()[1], 2);
+  ASSERT_EQ(lines[2]->get_start_point()[2], 2);
+  ASSERT_EQ(lines[2]->get_start_point()[3], 2);
+
+  ASSERT_EQ(lines[2]->get_end_point()[0], 3);
+  ASSERT_EQ(lines[2]->get_end_point()[1], 2);
+  ASSERT_EQ(lines[2]->get_end_point()[2], 3);
+  ASSERT_EQ(lines[2]->get_end_point()[3], 3);
+
+  ASSERT_EQ(lines[2]->get_outside_point()[0], 2);
+  ASSERT_EQ(lines[2]->get_outside_point()[1], 1);
+  ASSERT_EQ(lines[2]->get_outside_point()[2], 1);
+  ASSERT_EQ(lines[2]->get_outside_point()[3], 1);
 }
 
 TEST(PolygonTest, print) {
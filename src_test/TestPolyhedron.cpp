@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "Line.h"
 #include "Polyhedron.h"
 
@@ -52,6 +54,40 @@ TEST(PolyhedronTest, tetrahedron_volume) {
   ASSERT_NEAR(n[3], -1. / 3., 1e-10);
 }
 
+TEST(PolyhedronTest, tetrahedron_volumes) {
+  Polyhedron polyhedron;
+  Polyhedron::TetrahedronBatch batch;
+  // A batch which is not full
+  batch.count = 29;
+  for (int t = 0; t < batch.count; t++) {
+    for (int k = 0; k < 4; k++) {
+      batch.v1[k][t] = std::sin(1.0 + t + 0.3 * k);
+      batch.v2[k][t] = std::cos(2.0 + 0.7 * t - k);
+      batch.v3[k][t] = std::sin(0.5 * t * k + 3.0);
+      batch.outside[k][t] = std::cos(1.3 * t + 2.0 * k);
+    }
+  }
+  Polyhedron::tetrahedron_volumes(batch);
+
+  for (int t = 0; t < batch.count; t++) {
+    std::array<double, 4> v1, v2, v3, o, n;
+    for (int k = 0; k < 4; k++) {
+      v1[k] = batch.v1[k][t];
+      v2[k] = batch.v2[k][t];
+      v3[k] = batch.v3[k][t];
+      o[k] = batch.outside[k][t];
+    }
+    polyhedron.tetrahedron_volume(v1, v2, v3, n);
+    const double volume =
+        std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2] + n[3] * n[3]);
+    polyhedron.flip_normal_if_needed(n, o);
+    EXPECT_EQ(batch.volume[t], volume);
+    for (int k = 0; k < 4; k++) {
+      EXPECT_EQ(batch.n[k][t], n[k]);
+    }
+  }
+}
+
 TEST(PolyhedronTest, add_polygon) {
   Polyhedron polyhedron;
   Polygon polygon1;
@@ -173,6 +209,81 @@ TEST(PolyhedronTest, calculate_normal) {
   ASSERT_NEAR(normal[3], 0.0, 1e-5);
 }
 
+TEST(PolyhedronTest, normal_around_centroid) {
+  // The normal found together with the centroid, with the tetrahedrons
+  // around the mean point, agrees with the sum of the normals of the
+  // tetrahedrons around the final centroid within 1e-14 relative to the
+  // element. The polyhedron is a warped cube whose centroid is not at the
+  // mean of its corners.
+  std::array<std::array<double, 4>, 8> points;
+  for (int a = 0; a < 2; a++) {
+    for (int b = 0; b < 2; b++) {
+      for (int c = 0; c < 2; c++) {
+        points[4 * a + 2 * b + c] = {0.3 * a * b + 0.2 * c + 0.1 * a * c,
+                                     a * (1.0 + 0.5 * b), b + 0.3 * a * c,
+                                     c * (1.0 + 0.4 * a)};
+      }
+    }
+  }
+  // The corners of the six faces in order around each face
+  std::array<std::array<int, 4>, 6> faces = {{{0, 1, 3, 2},
+                                              {4, 5, 7, 6},
+                                              {0, 1, 5, 4},
+                                              {2, 3, 7, 6},
+                                              {0, 2, 6, 4},
+                                              {1, 3, 7, 5}}};
+  std::array<double, 4> out = {10, 0.5, 0.5, 0.5};
+  std::array<int, 2> const_i = {0, 1};
+  std::array<std::array<Line, 4>, 6> lines;
+  std::array<Polygon, 6> polygons;
+  Polyhedron polyhedron;
+  polyhedron.init_polyhedron();
+  for (int i = 0; i < 6; i++) {
+    polygons[i].init_polygon(0);
+    for (int j = 0; j < 4; j++) {
+      lines[i][j].init_line(
+          {points[faces[i][j]], points[faces[i][(j + 1) % 4]]}, out, const_i);
+      polygons[i].add_line(lines[i][j], true);
+    }
+    polyhedron.add_polygon(polygons[i], true);
+  }
+
+  const std::array<double, 4> normal = polyhedron.get_normal();
+  std::array<double, 4> centroid = polyhedron.get_centroid();
+  std::array<double, 4> mean = {0};
+  for (int i = 0; i < 8; i++) {
+    for (int k = 0; k < 4; k++) {
+      mean[k] += points[i][k] / 8;
+    }
+  }
+  EXPECT_GT(std::abs(centroid[0] - mean[0]), 1e-3);
+
+  std::array<double, 4> expected = {0};
+  for (int i = 0; i < 6; i++) {
+    const std::array<double, 4> cent = polygons[i].get_centroid();
+    for (int j = 0; j < 4; j++) {
+      std::array<double, 4> v1, v2, v3, o, n;
+      for (int k = 0; k < 4; k++) {
+        v1[k] = lines[i][j].get_start_point()[k] - centroid[k];
+        v2[k] = lines[i][j].get_end_point()[k] - centroid[k];
+        v3[k] = cent[k] - centroid[k];
+        o[k] = out[k] - centroid[k];
+      }
+      polyhedron.tetrahedron_volume(v1, v2, v3, n);
+      polyhedron.flip_normal_if_needed(n, o);
+      for (int k = 0; k < 4; k++) {
+        expected[k] += n[k];
+      }
+    }
+  }
+  const double size = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] +
+                                normal[2] * normal[2] + normal[3] * normal[3]);
+  EXPECT_GT(size, 0.5);
+  for (int k = 0; k < 4; k++) {
+    EXPECT_NEAR(normal[k], expected[k], 1e-14 * size);
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "SliceRange.h"
+
+TEST(SliceRangeTest, ranges_of_planes_and_lines) {
+  // Lines which are not a multiple of the word length
+  const int number_planes = 3;
+  const int lines_per_plane = 4;
+  const std::size_t line_size = 2 * SliceRange::WORD + 5;
+  const std::size_t plane_size = lines_per_plane * line_size;
+  std::vector<double> slice(number_planes * plane_size);
+  for (std::size_t p = 0; p < slice.size(); p++) {
+    slice[p] = std::sin(0.37 * p) * (1.0 + 0.01 * p);
+  }
+  SliceRange range;
+  range.init_slice_range(number_planes, lines_per_plane, line_size);
+  range.build(slice.data(), 0.0);
+  EXPECT_EQ(range.get_number_planes(), number_planes);
+  EXPECT_EQ(range.get_lines_per_plane(), lines_per_plane);
+  EXPECT_EQ(range.get_line_size(), line_size);
+
+  for (int plane = 0; plane < number_planes; plane++) {
+    const double* values = slice.data() + plane * plane_size;
+    EXPECT_EQ(range.get_plane_range(plane).min,
+              *std::min_element(values, values + plane_size));
+    EXPECT_EQ(range.get_plane_range(plane).max,
+              *std::max_element(values, values + plane_size));
+    for (int line = 0; line < lines_per_plane; line++) {
+      const double* points = values + line * line_size;
+      EXPECT_EQ(range.get_line_range(plane, line).min,
+                *std::min_element(points, points + line_size));
+      EXPECT_EQ(range.get_line_range(plane, line).max,
+                *std::max_element(points, points + line_size));
+    }
+  }
+}
+
+TEST(SliceRangeTest, may_cross) {
+  EXPECT_TRUE(SliceRange::may_cross({0.1, 0.9}, 0.5));
+  EXPECT_TRUE(SliceRange::may_cross({0.1, 0.5}, 0.5));
+  EXPECT_FALSE(SliceRange::may_cross({0.5, 0.9}, 0.5));
+  EXPECT_FALSE(SliceRange::may_cross({0.1, 0.4}, 0.5));
+  EXPECT_FALSE(SliceRange::may_cross(SliceRange::empty_range(), 0.5));
+
+  SliceRange::Range range = SliceRange::empty_range();
+  SliceRange::merge(range, {0.5, 0.9});
+  SliceRange::merge(range, {0.1, 0.4});
+  EXPECT_EQ(range.min, 0.1);
+  EXPECT_EQ(range.max, 0.9);
+}
+
+TEST(SliceRangeTest, nan_is_below) {
+  // A NaN corner is never at or above the value, so a line with NaN and
+  // values above the value may be crossed
+  std::vector<double> slice(10, 0.9);
+  slice[4] = std::nan("");
+  SliceRange range;
+  range.init_slice_range(1, 1, slice.size());
+  range.build(slice.data(), 0.5);
+  EXPECT_EQ(range.get_plane_range(0).max, 0.9);
+  EXPECT_TRUE(SliceRange::may_cross(range.get_plane_range(0), 0.5));
+  EXPECT_EQ(range.get_signs(0, 0)[0], 0x3efu);
+}
+
+TEST(SliceRangeTest, sign_bits) {
+  // Lines which are longer than a word, with a zero word after each line
+  const int number_planes = 2;
+  const int lines_per_plane = 3;
+  const std::size_t line_size = SliceRange::WORD + 7;
+  std::vector<double> slice(number_planes * lines_per_plane * line_size);
+  for (std::size_t p = 0; p < slice.size(); p++) {
+    slice[p] = std::sin(0.91 * p);
+  }
+  slice[5] = 0.25;
+  SliceRange range;
+  range.init_slice_range(number_planes, lines_per_plane, line_size);
+  range.build(slice.data(), 0.25);
+  EXPECT_EQ(range.get_value(), 0.25);
+  for (int plane = 0; plane < number_planes; plane++) {
+    for (int line = 0; line < lines_per_plane; line++) {
+      const double* values =
+          slice.data() + (plane * lines_per_plane + line) * line_size;
+      const std::uint64_t* words = range.get_signs(plane, line);
+      for (std::size_t p = 0; p < line_size; p++) {
+        const bool above = (words[p / SliceRange::WORD] >>
+                            (p % SliceRange::WORD)) & 1;
+        EXPECT_EQ(above, values[p] >= 0.25);
+      }
+      EXPECT_EQ(words[1] >> 7, 0u);
+      EXPECT_EQ(words[2], 0u);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
\ No newline at end of file
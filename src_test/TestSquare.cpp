@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "Square.h"
 
 TEST(SquareTest, init_square) {
@@ -27,6 +29,76 @@ TEST(SquareTest, construct_lines) {
   EXPECT_FALSE(square.is_ambiguous());
 }
 
+TEST(SquareTest, line_edges_ambiguous) {
+  // The center is above, so each line cuts off one corner below the value
+  Square square;
+  std::array<std::array<double, 2>, 2> sq = {{{1, 0}, {0, 1}}};
+  std::array<int, 2> c_i = {2, 3};
+  std::array<double, 2> c_v = {0, 0};
+  std::array<double, 4> dx = {0.1, 0.1, 0.1, 0.1};
+  square.init_square(sq, c_i, c_v, dx);
+  square.construct_lines(0.4);
+
+  ASSERT_EQ(square.get_number_lines(), 2);
+  EXPECT_TRUE(square.is_ambiguous());
+  EXPECT_EQ(square.get_line_edges(0), (std::array<int, 2>{0, 2}));
+  EXPECT_EQ(square.get_line_edges(1), (std::array<int, 2>{1, 3}));
+}
+
+TEST(SquareTest, edge_cut) {
+  // Corners on different sides of the value, and corners at the value
+  const std::array<double, 7> values_low = {0.2, 0.8, 0.5, 0.3, 0.5, 0.7, 0.5};
+  const std::array<double, 7> values_high = {0.6, 0.4, 0.3, 0.5, 0.5, 0.9,
+                                             0.8};
+  const std::array<double, 7> delta_x = {0.1, 0.2, 0.1, 0.1, 0.1, 0.1, 0.1};
+  std::array<double, 7> cuts;
+  Square::edge_cuts(7, values_low.data(), values_high.data(), 0.5,
+                    delta_x.data(), cuts.data());
+
+  EXPECT_DOUBLE_EQ(cuts[0], 0.075);
+  EXPECT_DOUBLE_EQ(cuts[1], 0.15);
+  EXPECT_DOUBLE_EQ(cuts[2], 1e-9 * 0.1);
+  EXPECT_DOUBLE_EQ(cuts[3], (1.0 - 1e-9) * 0.1);
+  // Not cut: both corners at the value, both above, or the other corner
+  // above the value
+  EXPECT_TRUE(std::isnan(cuts[4]));
+  EXPECT_TRUE(std::isnan(cuts[5]));
+  EXPECT_TRUE(std::isnan(cuts[6]));
+  for (int i = 0; i < 7; i++) {
+    const double cut =
+        Square::edge_cut(values_low[i], values_high[i], 0.5, delta_x[i]);
+    EXPECT_TRUE(cut == cuts[i] || (std::isnan(cut) && std::isnan(cuts[i])));
+  }
+}
+
+TEST(SquareTest, given_edge_cuts) {
+  // The lines are the same with the cuts found by the square or given
+  std::array<std::array<double, 2>, 2> sq = {{{1, 0.5}, {0, 1}}};
+  std::array<int, 2> c_i = {0, 3};
+  std::array<double, 2> c_v = {0, 0};
+  std::array<double, 4> dx = {0.1, 0.2, 0.3, 0.1};
+  Square square;
+  square.init_square(sq, c_i, c_v, dx);
+  square.construct_lines(0.5);
+
+  const std::array<double, 4> cuts = {
+      Square::edge_cut(1, 0, 0.5, dx[1]), Square::edge_cut(1, 0.5, 0.5, dx[2]),
+      Square::edge_cut(0, 1, 0.5, dx[2]), Square::edge_cut(0.5, 1, 0.5, dx[1])};
+  Square square_given;
+  square_given.init_square(sq, c_i, c_v, dx);
+  square_given.set_edge_cuts(cuts.data());
+  square_given.construct_lines(0.5);
+
+  ASSERT_EQ(square_given.get_number_lines(), square.get_number_lines());
+  for (int i = 0; i < square.get_number_lines(); i++) {
+    EXPECT_EQ(square_given.get_lines()[i].get_start_point(),
+              square.get_lines()[i].get_start_point());
+    EXPECT_EQ(square_given.get_lines()[i].get_end_point(),
+              square.get_lines()[i].get_end_point());
+    EXPECT_EQ(square_given.get_line_edges(i), square.get_line_edges(i));
+  }
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include "SurfaceElements.h"
+
+TEST(SurfaceElementsTest, Constructor) {
+  SurfaceElements elements;
+  EXPECT_EQ(elements.get_number_elements(), 0);
+  EXPECT_EQ(elements.get_dimension(), 4);
+}
+
+TEST(SurfaceElementsTest, throw_errors_out_of_range) {
+  SurfaceElements elements;
+  elements.init_elements(3, 10);
+  elements.add_element({0, 1, 2, 3}, {0, 4, 5, 6});
+
+  EXPECT_THROW(elements.get_normal_element(1, 0), std::out_of_range);
+  EXPECT_THROW(elements.get_normal_element(0, 3), std::out_of_range);
+  EXPECT_THROW(elements.get_centroid_element(1, 0), std::out_of_range);
+  EXPECT_THROW(elements.get_centroid_element(0, 3), std::out_of_range);
+  EXPECT_THROW(elements.get_normal_component(3), std::out_of_range);
+  EXPECT_THROW(elements.get_centroid_component(-1), std::out_of_range);
+}
+
+TEST(SurfaceElementsTest, components) {
+  SurfaceElements elements;
+  elements.init_elements(3, 2);
+  elements.add_element({0, 1, 2, 3}, {0, 4, 5, 6});
+  elements.add_element({0, 7, 8, 9}, {0, 10, 11, 12});
+  ASSERT_EQ(elements.get_number_elements(), 2);
+
+  // The padding entry is dropped and the components are contiguous
+  SurfaceElements::Span normal = elements.get_normal_component(1);
+  ASSERT_EQ(normal.size(), 2);
+  EXPECT_EQ(normal[0], 2);
+  EXPECT_EQ(normal[1], 8);
+  EXPECT_EQ(normal.end() - normal.begin(), 2);
+  SurfaceElements::Span centroid = elements.get_centroid_component(2);
+  EXPECT_EQ(centroid[0], 6);
+  EXPECT_EQ(centroid[1], 12);
+  EXPECT_EQ(elements.get_normal_element(1, 0), 7);
+  EXPECT_EQ(elements.get_centroid_element(0, 1), 5);
+}
+
+TEST(SurfaceElementsTest, clear_keeps_memory) {
+  SurfaceElements elements;
+  elements.init_elements(4, 4);
+  for (int i = 0; i < 4; i++) {
+    elements.add_element({1, 2, 3, 4}, {5, 6, 7, 8});
+  }
+  const double* data = elements.get_normal_component(0).data;
+  elements.clear();
+  EXPECT_EQ(elements.get_number_elements(), 0);
+  elements.add_element({1, 2, 3, 4}, {5, 6, 7, 8});
+  EXPECT_EQ(elements.get_normal_component(0).data, data);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}